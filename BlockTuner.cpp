@@ -0,0 +1,136 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * BlockTuner.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <thread>
+
+#include <stdio.h>
+
+#include "CSRGraph.h"
+#include "KernelGraphs.h"
+#include "ParallelLevels.h"
+#include "BlockTuner.h"
+
+using namespace std;
+
+typedef long long unsigned ull;
+
+BlockTuner::BlockTuner(unsigned threads) {
+	if(threads == 0)
+		threads = thread::hardware_concurrency();
+	this->threads = (threads > 0) ? threads : 1;
+	memoryBudget = 0;
+	valueBytes = sizeof(double);
+	minParallelism = 0;
+	best = 0;
+}
+
+void BlockTuner::evaluate(ull block, CSRGraph &graph) {
+	Candidate c;
+	c.block = block;
+	c.nodes = graph.nodes;
+	c.maxLive = graph.maxLive();
+
+	c.memAccesses = 0;
+	for(ull i=0; i<graph.nodes; i++)
+		c.memAccesses += graph.memType(i);
+
+	ParallelLevels levels(threads);
+	c.depth = levels.compute(graph);
+	c.parallelism = (c.depth > 0) ? (double)c.nodes / c.depth : 0;
+
+	c.feasible = (memoryBudget == 0 || c.maxLive * valueBytes <= memoryBudget) && c.parallelism >= minParallelism;
+	candidates.push_back(c);
+}
+
+ull BlockTuner::choose() {
+	best = 0;
+	for(unsigned i=1; i<candidates.size(); i++) {
+		Candidate &c = candidates[i];
+		Candidate &b = candidates[best];
+		if(c.feasible != b.feasible) {
+			if(c.feasible)
+				best = i;
+			continue;
+		}
+		if(c.feasible) {
+			if(c.memAccesses < b.memAccesses || (c.memAccesses == b.memAccesses && c.maxLive < b.maxLive))
+				best = i;
+		}
+		else if(c.maxLive < b.maxLive)
+			best = i;
+	}
+	return candidates.empty() ? 0 : candidates[best].block;
+}
+
+/*
+ * Block size for LinearAlgebra::dotProductBlockedRead(size,size,block)
+ */
+ull BlockTuner::tuneDotProduct(ull size) {
+	candidates.clear();
+	KernelGraphs generator(threads);
+	for(ull b=1; b<=size; b++) {
+		if(size % b != 0)
+			continue;
+		CSRGraph graph;
+		generator.dotProductBlockedRead(size,b,graph);
+		evaluate(b,graph);
+	}
+	return choose();
+}
+
+/*
+ * Block size for LinearAlgebra::matrixMatrixBlockMultiply(m1size,m2size,block)
+ */
+ull BlockTuner::tuneBlockMultiply(ull m1size, ull m2size) {
+	candidates.clear();
+	KernelGraphs generator(threads);
+	for(ull b=1; b<=m1size && b<=m2size; b++) {
+		if(m1size % b != 0 || m2size % b != 0)
+			continue;
+		CSRGraph graph;
+		generator.matrixMatrixBlockMultiply(m1size,m2size,b,graph);
+		evaluate(b,graph);
+	}
+	return choose();
+}
+
+/*
+ * Writes the chosen block size followed by one line per candidate:
+ * block nodes depth maxLive memAccesses parallelism feasible
+ */
+void BlockTuner::writeCandidates(string filename) {
+	FILE *fp = fopen(filename.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	if(!candidates.empty())
+		fprintf(fp,"best %llu\n",candidates[best].block);
+	for(unsigned i=0; i<candidates.size(); i++) {
+		Candidate &c = candidates[i];
+		fprintf(fp,"%llu %llu %llu %llu %llu %.2f %d\n",c.block,c.nodes,c.depth,c.maxLive,c.memAccesses,c.parallelism,c.feasible ? 1 : 0);
+	}
+
+	fclose(fp);
+}
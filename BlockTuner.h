@@ -0,0 +1,77 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * BlockTuner.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+
+#include "CSRGraph.h"
+
+#ifndef _BLOCKTUNER_
+#define _BLOCKTUNER_
+
+using namespace std;
+
+/*
+ * Picks the block size of a blocked LinearAlgebra kernel for a problem
+ * size. Every block size that divides the problem is evaluated on the graph
+ * from KernelGraphs (no tracing): peak live values (CSRGraph::maxLive),
+ * memory accesses and average parallelism (nodes per level). A block size
+ * is feasible when its live values fit in the memory budget and it reaches
+ * the target parallelism. The feasible one with the fewest memory accesses
+ * wins, ties go to fewer live values. Without a feasible one the fewest
+ * live values win.
+ */
+class BlockTuner {
+public:
+	unsigned threads;
+	//on-chip memory in bytes (0 is unlimited) and bytes per value
+	long long unsigned memoryBudget;
+	long long unsigned valueBytes;
+	//required nodes per level on average, 0 is no requirement
+	double minParallelism;
+
+	struct Candidate {
+		long long unsigned block;
+		long long unsigned nodes;
+		long long unsigned depth;
+		long long unsigned maxLive;
+		long long unsigned memAccesses;
+		double parallelism;
+		bool feasible;
+	};
+
+	//every block size evaluated by the last tuning and the chosen one
+	vector<Candidate> candidates;
+	unsigned best;
+
+	BlockTuner(unsigned threads = 0);
+
+	long long unsigned tuneDotProduct(long long unsigned size);
+	long long unsigned tuneBlockMultiply(long long unsigned m1size, long long unsigned m2size);
+	void writeCandidates(string filename);
+
+private:
+	void evaluate(long long unsigned block, CSRGraph &graph);
+	long long unsigned choose();
+};
+
+#endif
@@ -0,0 +1,527 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * CSRGraph.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <set>
+#include <string>
+#include <algorithm>
+
+#include <stdio.h>
+
+#include "Graph.h"
+#include "SparseSet.h"
+#include "SparseMatrix.h"
+#include "CSRGraph.h"
+
+using namespace std;
+
+CSRGraph::CSRGraph() {
+	nodes = 0;
+	edges = 0;
+	succOffset.push_back(0);
+	predOffset.push_back(0);
+}
+
+/*
+ * Builds the CSR form of a graph traced in full mode, size is the number
+ * of nodes (ie. opCount)
+ */
+CSRGraph::CSRGraph(SparseMatrix &matrix, long long unsigned size) {
+	set<SparseSet,SparseSetCompareRow, allocator<SparseSet> >::iterator it;
+
+	nodes = size;
+	edges = 0;
+	type.assign(size,0);
+	succOffset.assign(size+1,0);
+	predOffset.assign(size+1,0);
+
+	//count the degree of every node
+	for(it=matrix.data_row.begin(); it != matrix.data_row.end(); it++) {
+		if(it->i == it->j)
+			type[it->i] = it->data;
+		else if(it->data != 0) {
+			succOffset[it->i+1]++;
+			predOffset[it->j+1]++;
+			edges++;
+		}
+	}
+
+	for(long long unsigned i=0; i<size; i++) {
+		succOffset[i+1] += succOffset[i];
+		predOffset[i+1] += predOffset[i];
+	}
+
+	succ.resize(edges);
+	pred.resize(edges);
+
+	//fill in the lists, rows are visited in order so both lists come out sorted
+	vector<long long unsigned> predPos(predOffset.begin(),predOffset.end()-1);
+	long long unsigned pos = 0;
+	for(it=matrix.data_row.begin(); it != matrix.data_row.end(); it++) {
+		if(it->i != it->j && it->data != 0) {
+			succ[pos++] = it->j;
+			pred[predPos[it->j]++] = it->i;
+		}
+	}
+}
+
+/*
+ * Builds the graph from a list of (src,dst) edges and the diagonal value of
+ * each node. The edge list is consumed (cleared) to save memory.
+ */
+void CSRGraph::build(long long unsigned size, vector<int> &types, vector<pair<unsigned,unsigned> > &edgeList) {
+	nodes = size;
+	edges = edgeList.size();
+	type = types;
+	type.resize(size,0);
+	memory.clear();
+	succOffset.assign(size+1,0);
+	predOffset.assign(size+1,0);
+
+	for(long long unsigned e=0; e<edges; e++) {
+		succOffset[edgeList[e].first+1]++;
+		predOffset[edgeList[e].second+1]++;
+	}
+
+	for(long long unsigned i=0; i<size; i++) {
+		succOffset[i+1] += succOffset[i];
+		predOffset[i+1] += predOffset[i];
+	}
+
+	succ.resize(edges);
+	pred.resize(edges);
+
+	vector<long long unsigned> succPos(succOffset.begin(),succOffset.end()-1);
+	vector<long long unsigned> predPos(predOffset.begin(),predOffset.end()-1);
+	for(long long unsigned e=0; e<edges; e++) {
+		succ[succPos[edgeList[e].first]++] = edgeList[e].second;
+		pred[predPos[edgeList[e].second]++] = edgeList[e].first;
+	}
+
+	vector<pair<unsigned,unsigned> >().swap(edgeList);
+
+	//keep the lists sorted regardless of the order the edges were given in
+	for(long long unsigned i=0; i<size; i++) {
+		sort(succ.begin()+succOffset[i],succ.begin()+succOffset[i+1]);
+		sort(pred.begin()+predOffset[i],pred.begin()+predOffset[i+1]);
+	}
+}
+
+/*
+ * Reads a graph in the format written by Data::writeSparseMatrix: the
+ * number of nodes followed by one "i j value" line per entry
+ */
+bool CSRGraph::readSparseMatrix(string filename) {
+	FILE *fp = fopen(filename.c_str(),"r");
+	if(fp == NULL) {
+		printf("Unable to open %s for reading\n",filename.c_str());
+		return false;
+	}
+
+	long long unsigned size;
+	if(fscanf(fp,"%llu",&size) != 1) {
+		fclose(fp);
+		return false;
+	}
+
+	vector<int> types(size,0);
+	vector<pair<unsigned,unsigned> > edgeList;
+	long i,j;
+	int val;
+	while(fscanf(fp,"%ld %ld %d",&i,&j,&val) == 3) {
+		if(i == j)
+			types[i] = val;
+		else if(val != 0)
+			edgeList.push_back(pair<unsigned,unsigned>(i,j));
+	}
+	fclose(fp);
+
+	build(size,types,edgeList);
+	return true;
+}
+
+/*
+ * Writes the graph in the same format as Data::writeSparseMatrix
+ */
+void CSRGraph::writeSparseMatrix(string filename) {
+	FILE *fp = fopen(filename.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	fprintf(fp,"%llu\n",nodes);
+	for(long long unsigned i=0; i<nodes; i++) {
+		//successors always have higher ids so the diagonal comes first in the row
+		if(type[i] != 0)
+			fprintf(fp,"%llu %llu %d\n",i,i,type[i]);
+		for(long long unsigned e=succOffset[i]; e<succOffset[i+1]; e++)
+			fprintf(fp,"%llu %u 1\n",i,succ[e]);
+	}
+	fclose(fp);
+}
+
+int CSRGraph::opType(long long unsigned i) const {
+	return type[i] - Types::setMemType(Types::getMemType(type[i]));
+}
+
+int CSRGraph::memType(long long unsigned i) const {
+	if(!memory.empty())
+		return memory[i];
+	return Types::getMemType(type[i]);
+}
+
+/*
+ * Sets the exact number of memory accesses of node i, for nodes standing
+ * for several ops whose accesses do not fit in the type (which keeps at
+ * most 4 so files stay readable by the graph viewer)
+ */
+void CSRGraph::setMemory(long long unsigned i, long long unsigned count) {
+	if(memory.empty()) {
+		memory.resize(nodes);
+		for(long long unsigned k=0; k<nodes; k++)
+			memory[k] = Types::getMemType(type[k]);
+	}
+	memory[i] = count;
+}
+
+/*
+ * Dead node elimination: builds pruned from the nodes that can reach one of
+ * the outputs (including the outputs), renumbered in their original order
+ * so ids stay topological. Returns the original id of each kept node.
+ */
+vector<unsigned> CSRGraph::prune(vector<long long unsigned> &outputs, CSRGraph &pruned) {
+	vector<char> live(nodes,0);
+	for(long long unsigned k=0; k<outputs.size(); k++)
+		if(outputs[k] < nodes)
+			live[outputs[k]] = 1;
+
+	//every predecessor of a live node is live, ids are topological so one reverse pass is enough
+	for(long long unsigned i=nodes; i-- > 0; ) {
+		if(!live[i])
+			continue;
+		for(long long unsigned e=predOffset[i]; e<predOffset[i+1]; e++)
+			live[pred[e]] = 1;
+	}
+
+	vector<unsigned> original;
+	vector<unsigned> newId(nodes,0);
+	vector<int> types;
+	for(long long unsigned i=0; i<nodes; i++) {
+		if(!live[i])
+			continue;
+		newId[i] = original.size();
+		original.push_back(i);
+		types.push_back(type[i]);
+	}
+
+	vector<pair<unsigned,unsigned> > edgeList;
+	for(long long unsigned k=0; k<original.size(); k++) {
+		unsigned i = original[k];
+		for(long long unsigned e=succOffset[i]; e<succOffset[i+1]; e++)
+			if(live[succ[e]])
+				edgeList.push_back(pair<unsigned,unsigned>(k,newId[succ[e]]));
+	}
+
+	pruned.build(original.size(),types,edgeList);
+	if(!memory.empty())
+		for(long long unsigned k=0; k<original.size(); k++)
+			pruned.setMemory(k,memory[original[k]]);
+	return original;
+}
+
+/*
+ * Computes the ASAP level of every node, the same value stage mode keeps
+ * in Data::node: 0 for nodes with no predecessors, otherwise one more than
+ * the highest level of its predecessors
+ */
+vector<long long unsigned> CSRGraph::levels() {
+	vector<long long unsigned> level(nodes,0);
+
+	//ids are a topological order so predecessors are always done first
+	for(long long unsigned i=0; i<nodes; i++) {
+		for(long long unsigned e=predOffset[i]; e<predOffset[i+1]; e++) {
+			if(level[i] <= level[pred[e]])
+				level[i] = level[pred[e]]+1;
+		}
+	}
+
+	return level;
+}
+
+/*
+ * Computes the ALAP level of every node for the critical path length given
+ * by the ASAP levels: the last level a node can be placed in without
+ * delaying any of its successors
+ */
+vector<long long unsigned> CSRGraph::alapLevels(vector<long long unsigned> &level) {
+	long long unsigned depth = 0;
+	for(long long unsigned i=0; i<nodes; i++) {
+		if(level[i]+1 > depth)
+			depth = level[i]+1;
+	}
+
+	vector<long long unsigned> alap(nodes,0);
+
+	//reverse topological order so successors are always done first
+	for(long long unsigned i=nodes; i>0; i--) {
+		long long unsigned latest = depth-1;
+		for(long long unsigned e=succOffset[i-1]; e<succOffset[i]; e++) {
+			if(alap[succ[e]]-1 < latest)
+				latest = alap[succ[e]]-1;
+		}
+		alap[i-1] = latest;
+	}
+
+	return alap;
+}
+
+/*
+ * Returns the slack (mobility) of every node, alap - asap
+ */
+vector<long long unsigned> CSRGraph::slack(vector<long long unsigned> &level, vector<long long unsigned> &alap) {
+	vector<long long unsigned> mobility(nodes);
+	for(long long unsigned i=0; i<nodes; i++)
+		mobility[i] = alap[i] - level[i];
+	return mobility;
+}
+
+/*
+ * Returns the first leaf in [lo,hi] of the min segment tree whose value is
+ * at most val (or hi+1 if none) by descending only into subtrees that can
+ * contain it
+ */
+static long long unsigned firstAtMost(vector<long long unsigned> &tree, long long unsigned k, long long unsigned kLo, long long unsigned kHi,
+		long long unsigned lo, long long unsigned hi, long long unsigned val) {
+	if(kHi < lo || kLo > hi || tree[k] > val)
+		return hi+1;
+	if(kLo == kHi)
+		return kLo;
+
+	long long unsigned mid = (kLo+kHi)/2;
+	long long unsigned left = firstAtMost(tree,2*k,kLo,mid,lo,hi,val);
+	if(left <= hi)
+		return left;
+	return firstAtMost(tree,2*k+1,mid+1,kHi,lo,hi,val);
+}
+
+/*
+ * Places every node in a level between its ASAP and ALAP levels so as to
+ * even out the width of the stages. Nodes are placed in topological order,
+ * each in the least full level it can go in after its predecessors, found
+ * with a min segment tree over the levels in O(log depth) per node.
+ */
+vector<long long unsigned> CSRGraph::balancedLevels(vector<long long unsigned> &level, vector<long long unsigned> &alap) {
+	long long unsigned depth = 0;
+	for(long long unsigned i=0; i<nodes; i++) {
+		if(level[i]+1 > depth)
+			depth = level[i]+1;
+	}
+
+	long long unsigned size = 1;
+	while(size < depth){size *= 2;}
+
+	//leaves hold the width of each level, padding levels are never chosen
+	vector<long long unsigned> tree(2*size,0);
+	for(long long unsigned l=depth; l<size; l++)
+		tree[size+l] = (long long unsigned)-1;
+	for(long long unsigned k=size-1; k>0; k--)
+		tree[k] = min(tree[2*k],tree[2*k+1]);
+
+	vector<long long unsigned> placed(nodes,0);
+	for(long long unsigned i=0; i<nodes; i++) {
+		long long unsigned lo = level[i];
+		for(long long unsigned e=predOffset[i]; e<predOffset[i+1]; e++) {
+			if(placed[pred[e]]+1 > lo)
+				lo = placed[pred[e]]+1;
+		}
+		long long unsigned hi = alap[i];
+
+		//find the minimum width in [lo,hi]
+		long long unsigned best = (long long unsigned)-1;
+		for(long long unsigned a=lo+size, b=hi+size+1; a<b; a/=2, b/=2) {
+			if(a&1)
+				best = min(best,tree[a++]);
+			if(b&1)
+				best = min(best,tree[--b]);
+		}
+
+		//take the first level in range with that width
+		long long unsigned choice = firstAtMost(tree,1,0,size-1,lo,hi,best);
+
+		placed[i] = choice;
+		long long unsigned k = size+choice;
+		tree[k]++;
+		for(k/=2; k>0; k/=2)
+			tree[k] = min(tree[2*k],tree[2*k+1]);
+	}
+
+	return placed;
+}
+
+/*
+ * Counts the nodes in each level, the same as stage mode's opStages
+ */
+vector<long long unsigned> CSRGraph::stageHistogram(vector<long long unsigned> &level) {
+	vector<long long unsigned> hist;
+	for(long long unsigned i=0; i<level.size(); i++) {
+		if(hist.size() <= level[i])
+			hist.resize(level[i]+1,0);
+		hist[level[i]]++;
+	}
+	return hist;
+}
+
+/*
+ * Peak number of live values when the nodes execute in id (trace) order: a
+ * node's value is live from when it is computed until its last successor
+ * has executed, values nothing uses are never counted
+ */
+long long unsigned CSRGraph::maxLive() {
+	vector<long long unsigned> ending(nodes,0);
+	for(long long unsigned i=0; i<nodes; i++)
+		if(outDegree(i) > 0)
+			ending[succ[succOffset[i+1]-1]]++;
+
+	long long unsigned live = 0;
+	long long unsigned peak = 0;
+	for(long long unsigned i=0; i<nodes; i++) {
+		live -= ending[i];
+		if(outDegree(i) > 0)
+			live++;
+		if(live > peak)
+			peak = live;
+	}
+	return peak;
+}
+
+/*
+ * Writes the ASAP level, ALAP level and slack of every node as dense binary
+ * arrays: the number of nodes (8 bytes) followed by the three arrays of
+ * 8 byte values
+ */
+void CSRGraph::writeLevels(string filename) {
+	vector<long long unsigned> level = levels();
+	vector<long long unsigned> alap = alapLevels(level);
+	vector<long long unsigned> mobility = slack(level,alap);
+
+	FILE *fp = fopen(filename.c_str(),"wb");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	fwrite(&nodes,sizeof(nodes),1,fp);
+	if(nodes > 0) {
+		fwrite(&level[0],sizeof(long long unsigned),nodes,fp);
+		fwrite(&alap[0],sizeof(long long unsigned),nodes,fp);
+		fwrite(&mobility[0],sizeof(long long unsigned),nodes,fp);
+	}
+	fclose(fp);
+}
+
+/*
+ * Writes the stage histogram of the balanced levels, one count per line
+ * in the same format as stage mode's writeOpStages
+ */
+void CSRGraph::writeBalancedStages(string filename) {
+	vector<long long unsigned> level = levels();
+	vector<long long unsigned> alap = alapLevels(level);
+	vector<long long unsigned> balanced = balancedLevels(level,alap);
+	vector<long long unsigned> hist = stageHistogram(balanced);
+
+	ofstream myfile;
+	myfile.open (filename.c_str());
+
+	for(long long unsigned i=0; i<hist.size(); i++) {
+		myfile << hist[i] << "\n";
+	}
+	myfile.close();
+}
+
+/*
+ * Computes the histogram of edge spans (consumer level - producer level)
+ * for the given levels. The maximum span into each op type is returned in
+ * opMax, indexed by op type.
+ */
+vector<long long unsigned> CSRGraph::spanHistogram(vector<long long unsigned> &level, vector<long long unsigned> &opMax) {
+	vector<long long unsigned> hist;
+
+	for(long long unsigned i=0; i<nodes; i++) {
+		int op = opType(i);
+		for(long long unsigned e=predOffset[i]; e<predOffset[i+1]; e++) {
+			long long unsigned span = level[i] - level[pred[e]];
+
+			if(hist.size() <= span)
+				hist.resize(span+1,0);
+			hist[span]++;
+
+			if(opMax.size() <= (unsigned)op)
+				opMax.resize(op+1,0);
+			if(span > opMax[op])
+				opMax[op] = span;
+		}
+	}
+
+	return hist;
+}
+
+/*
+ * Writes the edge span histogram of the graph using ASAP levels in the
+ * same format as stage mode's Data::writeSpans, including the max line of
+ * every op type in the graph
+ */
+void CSRGraph::writeSpans(string filename) {
+	vector<long long unsigned> level = levels();
+	vector<long long unsigned> opMax;
+	vector<long long unsigned> hist = spanHistogram(level,opMax);
+
+	vector<bool> present(opMax.size(),false);
+	for(long long unsigned i=0; i<nodes; i++) {
+		int op = opType(i);
+		if(present.size() <= (unsigned)op) {
+			present.resize(op+1,false);
+			opMax.resize(op+1,0);
+		}
+		present[op] = true;
+	}
+
+	ofstream myfile;
+	myfile.open (filename.c_str());
+
+	for(long long unsigned i=0; i<hist.size(); i++) {
+		if(hist[i] > 0)
+			myfile << i << " " << hist[i] << "\n";
+	}
+
+	for(unsigned j=0; j<opMax.size(); j++) {
+		if(present[j]) {
+			myfile << "max " << Types::getName(j);
+			if((int)j > Types::user)
+				myfile << j - Types::user;
+			myfile << " " << opMax[j] << "\n";
+		}
+	}
+	myfile.close();
+}
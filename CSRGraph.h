@@ -0,0 +1,86 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * CSRGraph.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+
+#include "SparseMatrix.h"
+
+#ifndef _CSRGRAPH_
+#define _CSRGRAPH_
+
+using namespace std;
+
+/*
+ * Compressed sparse row form of a traced graph for analysis passes. Holds
+ * both the successor and predecessor lists of every node so either can be
+ * iterated in order. Node ids are the op numbers from tracing, which are
+ * already a topological order (every edge goes from a lower to a higher id).
+ */
+class CSRGraph {
+public:
+	long long unsigned nodes;
+	long long unsigned edges;
+
+	//diagonal value of each node (op type + memory type)
+	vector<int> type;
+
+	//exact memory accesses of every node, only filled in once a node has
+	//more than the 4 its type can hold (see setMemory), empty otherwise
+	vector<long long unsigned> memory;
+
+	//successors of node i are succ[succOffset[i]] to succ[succOffset[i+1]-1]
+	vector<long long unsigned> succOffset;
+	vector<unsigned> succ;
+
+	//predecessors of node i are pred[predOffset[i]] to pred[predOffset[i+1]-1]
+	vector<long long unsigned> predOffset;
+	vector<unsigned> pred;
+
+	CSRGraph();
+	CSRGraph(SparseMatrix &matrix, long long unsigned size);
+
+	void build(long long unsigned size, vector<int> &types, vector<pair<unsigned,unsigned> > &edgeList);
+	bool readSparseMatrix(string filename);
+	void writeSparseMatrix(string filename);
+
+	long long unsigned outDegree(long long unsigned i) const { return succOffset[i+1] - succOffset[i]; }
+	long long unsigned inDegree(long long unsigned i) const { return predOffset[i+1] - predOffset[i]; }
+	int opType(long long unsigned i) const;
+	int memType(long long unsigned i) const;
+	void setMemory(long long unsigned i, long long unsigned count);
+
+	vector<unsigned> prune(vector<long long unsigned> &outputs, CSRGraph &pruned);
+
+	vector<long long unsigned> levels();
+	vector<long long unsigned> alapLevels(vector<long long unsigned> &levels);
+	vector<long long unsigned> slack(vector<long long unsigned> &levels, vector<long long unsigned> &alap);
+	vector<long long unsigned> balancedLevels(vector<long long unsigned> &levels, vector<long long unsigned> &alap);
+	static vector<long long unsigned> stageHistogram(vector<long long unsigned> &levels);
+	long long unsigned maxLive();
+	void writeLevels(string filename);
+	void writeBalancedStages(string filename);
+	vector<long long unsigned> spanHistogram(vector<long long unsigned> &levels, vector<long long unsigned> &opMax);
+	void writeSpans(string filename);
+};
+
+#endif
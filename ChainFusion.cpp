@@ -0,0 +1,188 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ChainFusion.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <algorithm>
+
+#include <stdio.h>
+
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "ChainFusion.h"
+
+using namespace std;
+
+typedef long long unsigned ull;
+
+ChainFusion::ChainFusion(unsigned maxLen) {
+	defaultLatency = 1;
+	maxLength = maxLen;
+	chains = 0;
+	fused = 0;
+}
+
+void ChainFusion::setLatency(int op, unsigned lat) {
+	if(latency.size() <= (unsigned)op)
+		latency.resize(op+1,defaultLatency);
+	latency[op] = lat;
+}
+
+unsigned ChainFusion::getLatency(int op) {
+	return ((unsigned)op < latency.size()) ? latency[op] : defaultLatency;
+}
+
+bool ChainFusion::elementwise(int op) {
+	return op == Types::Add || op == Types::Sub || op == Types::Mult || op == Types::Div || op == Types::Mod ||
+			op == Types::Scale || op == Types::eMult || op == Types::Square || op == Types::FMA;
+}
+
+/*
+ * Builds the fused graph where every chain of two or more elementwise ops
+ * is replaced by one Fused node with the memory accesses of the whole
+ * chain. A chain with more than the 4 accesses its type can hold gets its
+ * exact count through CSRGraph::setMemory, so the fused graph has the same
+ * memory traffic. Nodes listed in outputs always end their chain. Returns
+ * the number of nodes removed.
+ */
+long long unsigned ChainFusion::fuse(CSRGraph &graph, CSRGraph &result, vector<long long unsigned> *outputs) {
+	ull n = graph.nodes;
+
+	vector<char> keep(n,0);
+	if(outputs != NULL)
+		for(ull k=0; k<outputs->size(); k++)
+			if(outputs->at(k) < n)
+				keep[outputs->at(k)] = 1;
+
+	//the op before each node in its chain (itself if it starts one)
+	vector<unsigned> prev(n,0);
+	vector<ull> chainLength(n,1);
+	vector<char> merged(n,0);
+	for(ull v=0; v<n; v++) {
+		prev[v] = v;
+		if(!elementwise(graph.opType(v)))
+			continue;
+		for(ull e=graph.predOffset[v]; e<graph.predOffset[v+1]; e++) {
+			unsigned u = graph.pred[e];
+			if(keep[u] || graph.outDegree(u) != 1 || !elementwise(graph.opType(u)))
+				continue;
+			if(maxLength != 0 && chainLength[u] >= maxLength)
+				continue;
+			if(prev[v] == v || chainLength[u] >= chainLength[prev[v]])
+				prev[v] = u;
+		}
+		if(prev[v] != v) {
+			merged[prev[v]] = 1;
+			chainLength[v] = chainLength[prev[v]] + 1;
+		}
+	}
+
+	//the last op of each chain, successors always have higher ids
+	vector<unsigned> tail(n,0);
+	for(ull i=n; i-- > 0; )
+		tail[i] = merged[i] ? tail[graph.succ[graph.succOffset[i]]] : i;
+
+	original.clear();
+	memberOffset.assign(1,0);
+	member.clear();
+	cost.clear();
+	memory.clear();
+	chains = 0;
+	vector<unsigned> newId(n,0);
+	vector<int> types;
+	bool capped = !graph.memory.empty();
+	for(ull i=0; i<n; i++) {
+		if(merged[i])
+			continue;
+		newId[i] = original.size();
+		original.push_back(i);
+
+		ull first = member.size();
+		ull mem = 0;
+		ull time = 0;
+		for(unsigned j=i; ; j=prev[j]) {
+			member.push_back(j);
+			mem += graph.memType(j);
+			time += getLatency(graph.opType(j));
+			if(prev[j] == j)
+				break;
+		}
+		reverse(member.begin()+first,member.end());
+		memberOffset.push_back(member.size());
+		cost.push_back(time);
+		memory.push_back(mem);
+
+		if(member.size() - first > 1) {
+			//the type holds at most 4 memory accesses
+			types.push_back(Types::setMemType(mem > 4 ? 4 : mem) + Types::Fused);
+			capped = capped || mem > 4;
+			chains++;
+		}
+		else
+			types.push_back(graph.type[i]);
+	}
+
+	//edges into a chain go to its last op, an operand feeding a chain twice is one edge
+	vector<pair<unsigned,unsigned> > edgeList;
+	for(ull k=0; k<original.size(); k++) {
+		ull first = edgeList.size();
+		for(ull m=memberOffset[k]; m<memberOffset[k+1]; m++) {
+			unsigned i = member[m];
+			for(ull e=graph.succOffset[i]; e<graph.succOffset[i+1]; e++)
+				if(tail[graph.succ[e]] != original[k])
+					edgeList.push_back(pair<unsigned,unsigned>(k,newId[tail[graph.succ[e]]]));
+		}
+		sort(edgeList.begin()+first,edgeList.end());
+		edgeList.erase(unique(edgeList.begin()+first,edgeList.end()),edgeList.end());
+	}
+
+	result.build(original.size(),types,edgeList);
+	if(capped)
+		for(ull k=0; k<memory.size(); k++)
+			result.setMemory(k,memory[k]);
+
+	fused = n - original.size();
+	return fused;
+}
+
+/*
+ * Writes one line per Fused node: its id in the fused graph, its cost, its
+ * exact memory accesses and then the op names of its members in order
+ * (graph is the original graph)
+ */
+void ChainFusion::writeFusion(CSRGraph &graph, string filename) {
+	FILE *fp = fopen(filename.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	for(ull i=0; i<original.size(); i++) {
+		if(length(i) < 2)
+			continue;
+		fprintf(fp,"%llu %llu %llu",i,cost[i],memory[i]);
+		for(ull m=memberOffset[i]; m<memberOffset[i+1]; m++)
+			fprintf(fp," %s",Types::getName(graph.type[member[m]]));
+		fprintf(fp,"\n");
+	}
+
+	fclose(fp);
+}
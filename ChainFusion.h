@@ -0,0 +1,81 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ChainFusion.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+
+#include "CSRGraph.h"
+
+#ifndef _CHAINFUSION_
+#define _CHAINFUSION_
+
+using namespace std;
+
+/*
+ * Fuses chains of elementwise ops into single Fused nodes, the way a fused
+ * hardware operator (eg. square then add, scale then subtract) executes
+ * them without writing back the intermediate values. An op joins the chain
+ * of its successor when that successor is its only consumer and both are
+ * elementwise. Each node extends at most one chain (the longest one
+ * feeding it) so fused nodes are paths, not trees. The fused node takes
+ * the position of the last op of the chain and every edge into the chain.
+ *
+ * Scale, eMult and Square count as elementwise, but Data never traces
+ * them: a square is a Mult of a value with itself and scaling is a Mult
+ * by a constant. Emitting those types while tracing is out of scope here,
+ * so traced chains are built from Add, Sub, Mult, Div, Mod and FMA ops.
+ */
+class ChainFusion {
+public:
+	//latency of each op type (indexed by op type) for the cost of fused nodes
+	vector<unsigned> latency;
+	unsigned defaultLatency;
+	//longest chain fused into one node, 0 is unlimited
+	unsigned maxLength;
+
+	//per node of the fused graph: original ids of the ops it executes (in
+	//order) are member[memberOffset[i]] to member[memberOffset[i+1]-1]
+	vector<long long unsigned> memberOffset;
+	vector<unsigned> member;
+	//per node of the fused graph: sum of the latencies of its ops and of
+	//their memory accesses
+	vector<long long unsigned> cost;
+	vector<long long unsigned> memory;
+	//original id of each node of the fused graph (the last op of its chain)
+	vector<unsigned> original;
+
+	long long unsigned chains;
+	//nodes removed by the last fusion
+	long long unsigned fused;
+
+	ChainFusion(unsigned maxLength = 0);
+
+	void setLatency(int op, unsigned lat);
+	unsigned getLatency(int op);
+	static bool elementwise(int op);
+
+	long long unsigned fuse(CSRGraph &graph, CSRGraph &result, vector<long long unsigned> *outputs = NULL);
+	long long unsigned length(long long unsigned i) const { return memberOffset[i+1] - memberOffset[i]; }
+	void writeFusion(CSRGraph &graph, string filename);
+};
+
+#endif
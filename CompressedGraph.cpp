@@ -0,0 +1,746 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * CompressedGraph.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <stdio.h>
+
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "CompressedGraph.h"
+
+using namespace std;
+
+typedef long long unsigned ull;
+
+static const ull HashBase = 0x100000001B3ULL;
+
+size_t CompressedGraph::VectorHash::operator()(const vector<ull> &v) const {
+	ull h = 0xCBF29CE484222325ULL;
+	for(unsigned i=0; i<v.size(); i++)
+		h = (h ^ v[i]) * HashBase;
+	return (size_t)(h ^ (h >> 32));
+}
+
+CompressedGraph::CompressedGraph(unsigned window, unsigned maxLevels) {
+	this->window = (window > 0) ? window : 1;
+	this->maxLevels = maxLevels;
+	appended = 0;
+	farthest = 0;
+
+	levels.resize(maxLevels);
+	for(unsigned i=0; i<maxLevels; i++) {
+		levels[i].prefix.assign(1,0);
+		levels[i].base = 0;
+		levels[i].inRun = false;
+		levels[i].count = 0;
+		levels[i].pos = 0;
+	}
+
+	affine.prefix.assign(1,0);
+	affine.base = 0;
+	affine.inRun = false;
+	affine.count = 0;
+	affine.pos = 0;
+
+	power.assign(2*this->window+2,1);
+	for(unsigned i=1; i<power.size(); i++)
+		power[i] = power[i-1] * HashBase;
+}
+
+unsigned CompressedGraph::intern(vector<ull> &key, Symbol &sym) {
+	unordered_map<vector<ull>,unsigned,VectorHash>::iterator it = interned.find(key);
+	if(it != interned.end())
+		return it->second;
+
+	unsigned id = symbols.size();
+	symbols.push_back(sym);
+	interned[key] = id;
+	return id;
+}
+
+/*
+ * Nodes of the same shape (type and number of predecessors) can form
+ * affine runs
+ */
+unsigned CompressedGraph::shapeOf(int type, unsigned preds) {
+	ull shapeKey = ((ull)(unsigned)type << 32) | preds;
+	unordered_map<ull,unsigned>::iterator it = shapes.find(shapeKey);
+	if(it == shapes.end())
+		it = shapes.insert(pair<ull,unsigned>(shapeKey,shapes.size())).first;
+	return it->second;
+}
+
+/*
+ * Returns the symbol of a node with the given type and (sorted)
+ * predecessor distances
+ */
+unsigned CompressedGraph::literal(int type, vector<ull> &offsets) {
+	Symbol sym;
+	sym.run = false;
+	sym.affine = false;
+	sym.type = type;
+	sym.shape = shapeOf(type,offsets.size());
+	sym.offsets = offsets;
+	sym.count = 1;
+	sym.nodes = 1;
+	sym.edges = offsets.size();
+
+	vector<ull> key;
+	key.push_back(0);
+	key.push_back((ull)(long long)type);
+	key.insert(key.end(),offsets.begin(),offsets.end());
+	return intern(key,sym);
+}
+
+/*
+ * Adds the next node (id = number of nodes appended so far) with the ids
+ * of its predecessors
+ */
+void CompressedGraph::append(int type, ull *preds, unsigned count) {
+	Node node;
+	node.type = type;
+	node.shape = shapeOf(type,count);
+	for(unsigned i=0; i<count; i++) {
+		ull offset = appended - preds[i];
+		node.offsets.push_back(offset);
+		if(offset > farthest)
+			farthest = offset;
+	}
+	sort(node.offsets.begin(),node.offsets.end());
+
+	appended++;
+	feedAffine(node);
+}
+
+void CompressedGraph::push(unsigned level, unsigned sym) {
+	if(level >= maxLevels)
+		items.push_back(sym);
+	else
+		feed(level,sym);
+}
+
+void CompressedGraph::emit(unsigned level, unsigned sym) {
+	push(level+1,sym);
+}
+
+ull CompressedGraph::blockHash(vector<ull> &prefix, ull from, ull to) {
+	return prefix[to] - prefix[from] * power[to-from];
+}
+
+/*
+ * Passes all but the last keep symbols of the level's buffer on to the
+ * next level
+ */
+void CompressedGraph::trim(unsigned level, ull keep) {
+	Level &l = levels[level];
+	ull drop = l.buffer.size() - keep;
+	for(ull i=0; i<drop; i++)
+		emit(level,l.buffer[i]);
+
+	Level &m = levels[level];
+	m.buffer.erase(m.buffer.begin(),m.buffer.begin()+drop);
+	m.base += drop;
+	m.prefix.assign(1,0);
+	for(ull i=0; i<m.buffer.size(); i++)
+		m.prefix.push_back(m.prefix.back() * HashBase + m.buffer[i] + 1);
+}
+
+/*
+ * Passes the current affine run on to the first level and returns the
+ * nodes of the unfinished instance after it
+ */
+vector<CompressedGraph::Node> CompressedGraph::endAffine() {
+	AffineLevel &l = affine;
+
+	Symbol run;
+	run.run = true;
+	run.affine = false;
+	run.type = 0;
+	run.shape = 0;
+	run.count = l.count;
+	run.nodes = l.body.size() * l.count;
+	run.edges = 0;
+	for(ull j=0; j<l.body.size(); j++) {
+		run.body.push_back(literal(l.body[j].type,l.body[j].offsets));
+		run.edges += l.body[j].offsets.size();
+	}
+	run.edges *= run.count;
+
+	//runs with no change in distance are exact runs
+	for(ull k=0; k<l.delta.size(); k++)
+		if(l.delta[k] != 0)
+			run.affine = true;
+
+	vector<ull> key;
+	key.push_back(run.affine ? 2 : 1);
+	key.push_back(run.count);
+	key.insert(key.end(),run.body.begin(),run.body.end());
+	if(run.affine) {
+		run.delta = l.delta;
+		for(ull k=0; k<l.delta.size(); k++)
+			key.push_back((ull)l.delta[k]);
+	}
+
+	//the nodes of the unfinished instance
+	vector<Node> leftover(l.body.begin(),l.body.begin()+l.pos);
+	for(ull j=0; j<leftover.size(); j++)
+		for(ull k=0; k<leftover[j].offsets.size(); k++)
+			leftover[j].offsets[k] += l.count * l.delta[l.deltaStart[j]+k];
+
+	l.inRun = false;
+	l.body.clear();
+	l.delta.clear();
+	l.deltaStart.clear();
+	push(0,intern(key,run));
+
+	return leftover;
+}
+
+/*
+ * Affine run detection on the node stream: the buffer is checked for
+ * ending in three blocks of nodes with the same shapes where every
+ * predecessor distance changes by the same amount from the first block to
+ * the second as from the second to the third. Following nodes continue the
+ * run as long as they match the next step of the progression.
+ */
+void CompressedGraph::feedAffine(Node &node) {
+	AffineLevel &l = affine;
+
+	if(l.inRun) {
+		Node &b = l.body[l.pos];
+		bool match = (node.shape == b.shape);
+		for(ull k=0; match && k<node.offsets.size(); k++)
+			match = (node.offsets[k] == b.offsets[k] + l.count * l.delta[l.deltaStart[l.pos]+k]);
+
+		if(match) {
+			if(++l.pos == l.body.size()) {
+				l.count++;
+				l.pos = 0;
+			}
+			return;
+		}
+
+		vector<Node> leftover = endAffine();
+		for(unsigned i=0; i<leftover.size(); i++)
+			feedAffine(leftover[i]);
+		feedAffine(node);
+		return;
+	}
+
+	l.buffer.push_back(node);
+	l.prefix.push_back(l.prefix.back() * HashBase + node.shape + 1);
+	ull e = l.buffer.size();
+
+	vector<ull> &recent = l.seen[node.shape];
+	for(ull r=recent.size(); r-- > 0; ) {
+		if(recent[r] < l.base)
+			break;
+		ull len = (e-1) - (recent[r] - l.base);
+		if(len > window || 3*len > e)
+			continue;
+		ull c0 = e-3*len, c1 = e-2*len, c2 = e-len;
+		if(blockHash(l.prefix,c0,c1) != blockHash(l.prefix,c1,c2) || blockHash(l.prefix,c1,c2) != blockHash(l.prefix,c2,e))
+			continue;
+
+		bool match = true;
+		vector<long long> delta;
+		vector<unsigned> deltaStart;
+		for(ull j=0; match && j<len; j++) {
+			Node &x0 = l.buffer[c0+j];
+			Node &x1 = l.buffer[c1+j];
+			Node &x2 = l.buffer[c2+j];
+			match = (x0.shape == x1.shape && x1.shape == x2.shape);
+			deltaStart.push_back(delta.size());
+			for(ull k=0; match && k<x0.offsets.size(); k++) {
+				long long d = (long long)(x1.offsets[k] - x0.offsets[k]);
+				match = ((long long)(x2.offsets[k] - x1.offsets[k]) == d);
+				delta.push_back(d);
+			}
+		}
+		if(!match)
+			continue;
+
+		//three instances at the end, everything before them moves up
+		vector<Node> prefixNodes(l.buffer.begin(),l.buffer.begin()+c0);
+		l.body.assign(l.buffer.begin()+c0,l.buffer.begin()+c1);
+		l.delta = delta;
+		l.deltaStart = deltaStart;
+		l.count = 3;
+		l.pos = 0;
+		l.inRun = true;
+		l.buffer.clear();
+		l.prefix.assign(1,0);
+		l.base += e;
+
+		for(ull i=0; i<prefixNodes.size(); i++)
+			push(0,literal(prefixNodes[i].type,prefixNodes[i].offsets));
+		return;
+	}
+
+	recent.push_back(l.base + e - 1);
+	if(recent.size() > 4)
+		recent.erase(recent.begin());
+
+	//pass on all but the last window nodes once the buffer gets long
+	if(e > 4*(ull)window) {
+		ull drop = e - 3*(ull)window;
+		for(ull i=0; i<drop; i++)
+			push(0,literal(l.buffer[i].type,l.buffer[i].offsets));
+		l.buffer.erase(l.buffer.begin(),l.buffer.begin()+drop);
+		l.base += drop;
+		l.prefix.assign(1,0);
+		for(ull i=0; i<l.buffer.size(); i++)
+			l.prefix.push_back(l.prefix.back() * HashBase + l.buffer[i].shape + 1);
+	}
+}
+
+/*
+ * Passes the level's current run on to the next level and returns the
+ * symbols of the unfinished instance after it
+ */
+vector<unsigned> CompressedGraph::endRun(unsigned level) {
+	Level &l = levels[level];
+
+	Symbol run;
+	run.run = true;
+	run.affine = false;
+	run.type = 0;
+	run.shape = 0;
+	run.body = l.body;
+	run.count = l.count;
+	run.nodes = 0;
+	run.edges = 0;
+	for(unsigned i=0; i<run.body.size(); i++) {
+		run.nodes += symbols[run.body[i]].nodes;
+		run.edges += symbols[run.body[i]].edges;
+	}
+	run.nodes *= run.count;
+	run.edges *= run.count;
+
+	vector<ull> key;
+	key.push_back(1);
+	key.push_back(run.count);
+	key.insert(key.end(),run.body.begin(),run.body.end());
+
+	vector<unsigned> leftover(l.body.begin(),l.body.begin()+l.pos);
+	l.inRun = false;
+	l.body.clear();
+	emit(level,intern(key,run));
+
+	return leftover;
+}
+
+/*
+ * Online repeat detection: while in a run each symbol is checked against
+ * the template, otherwise the symbol is buffered and the buffer is checked
+ * for ending in two copies of the same block, the shortest such block
+ * (starting at an earlier occurrence of the symbol) becomes the template.
+ */
+void CompressedGraph::feed(unsigned level, unsigned sym) {
+	Level &l = levels[level];
+
+	if(l.inRun) {
+		if(sym == l.body[l.pos]) {
+			if(++l.pos == l.body.size()) {
+				l.count++;
+				l.pos = 0;
+			}
+			return;
+		}
+
+		//the run ended, the partial instance is looked at again
+		vector<unsigned> leftover = endRun(level);
+		for(unsigned i=0; i<leftover.size(); i++)
+			feed(level,leftover[i]);
+		feed(level,sym);
+		return;
+	}
+
+	l.buffer.push_back(sym);
+	l.prefix.push_back(l.prefix.back() * HashBase + sym + 1);
+	ull e = l.buffer.size();
+
+	vector<ull> &recent = l.seen[sym];
+	for(ull k=recent.size(); k-- > 0; ) {
+		if(recent[k] < l.base)
+			break;
+		ull len = (e-1) - (recent[k] - l.base);
+		if(len > window || 2*len > e)
+			continue;
+		if(blockHash(l.prefix,e-2*len,e-len) != blockHash(l.prefix,e-len,e))
+			continue;
+		if(!equal(l.buffer.begin()+(e-2*len),l.buffer.begin()+(e-len),l.buffer.begin()+(e-len)))
+			continue;
+
+		//found two copies at the end, everything before them moves up
+		vector<unsigned> prefixItems(l.buffer.begin(),l.buffer.begin()+(e-2*len));
+		l.body.assign(l.buffer.begin()+(e-len),l.buffer.end());
+		l.count = 2;
+		l.pos = 0;
+		l.inRun = true;
+		l.buffer.clear();
+		l.prefix.assign(1,0);
+		l.base += e;
+
+		for(ull i=0; i<prefixItems.size(); i++)
+			emit(level,prefixItems[i]);
+		return;
+	}
+
+	recent.push_back(l.base + e - 1);
+	if(recent.size() > 4)
+		recent.erase(recent.begin());
+
+	if(l.buffer.size() > 2*(ull)window)
+		trim(level,window);
+}
+
+/*
+ * Flushes all pending runs and buffered symbols, call once after the last
+ * node has been appended
+ */
+void CompressedGraph::finish() {
+	while(affine.inRun) {
+		vector<Node> leftover = endAffine();
+		for(ull i=0; i<leftover.size(); i++)
+			feedAffine(leftover[i]);
+	}
+	vector<Node> pending;
+	pending.swap(affine.buffer);
+	affine.prefix.assign(1,0);
+	affine.base += pending.size();
+	for(ull i=0; i<pending.size(); i++)
+		push(0,literal(pending[i].type,pending[i].offsets));
+
+	for(unsigned level=0; level<maxLevels; level++) {
+		//the unfinished instance after a run can start another (shorter) run
+		while(levels[level].inRun) {
+			vector<unsigned> leftover = endRun(level);
+			for(ull i=0; i<leftover.size(); i++)
+				feed(level,leftover[i]);
+		}
+
+		Level &m = levels[level];
+		vector<unsigned> rest;
+		rest.swap(m.buffer);
+		m.prefix.assign(1,0);
+		m.base += rest.size();
+		for(ull i=0; i<rest.size(); i++)
+			emit(level,rest[i]);
+	}
+}
+
+/*
+ * Visits the nodes of a symbol in id order without expanding the graph
+ */
+template <class Visitor>
+static void walk(vector<CompressedGraph::Symbol> &symbols, unsigned s, ull &id, Visitor &visit) {
+	CompressedGraph::Symbol &sym = symbols[s];
+	if(!sym.run) {
+		visit(id,sym.type,sym.offsets);
+		id++;
+		return;
+	}
+
+	if(sym.affine) {
+		vector<ull> offsets;
+		for(ull c=0; c<sym.count; c++) {
+			ull d = 0;
+			for(unsigned b=0; b<sym.body.size(); b++) {
+				CompressedGraph::Symbol &node = symbols[sym.body[b]];
+				offsets.resize(node.offsets.size());
+				for(unsigned k=0; k<offsets.size(); k++)
+					offsets[k] = node.offsets[k] + c * sym.delta[d++];
+				visit(id,node.type,offsets);
+				id++;
+			}
+		}
+		return;
+	}
+
+	for(ull c=0; c<sym.count; c++)
+		for(unsigned b=0; b<sym.body.size(); b++)
+			walk(symbols,sym.body[b],id,visit);
+}
+
+//collects the nodes and edges of the expanded graph
+struct ExpandVisitor {
+	vector<int> types;
+	vector<pair<unsigned,unsigned> > edgeList;
+
+	void operator()(ull id, int type, vector<ull> &offsets) {
+		types.push_back(type);
+		for(unsigned k=0; k<offsets.size(); k++)
+			edgeList.push_back(pair<unsigned,unsigned>(id-offsets[k],id));
+	}
+};
+
+//ASAP levels, only the last (farthest edge) levels are kept
+struct StageVisitor {
+	vector<ull> ring;
+	vector<ull> hist;
+
+	//walk passes every visitor the op type, levels do not need it
+	void operator()(ull id, int, vector<ull> &offsets) {
+		ull level = 0;
+		for(unsigned k=0; k<offsets.size(); k++) {
+			ull l = ring[(id-offsets[k]) % ring.size()] + 1;
+			if(l > level)
+				level = l;
+		}
+		ring[id % ring.size()] = level;
+		if(hist.size() <= level)
+			hist.resize(level+1,0);
+		hist[level]++;
+	}
+};
+
+/*
+ * Compresses a whole graph (the graph's nodes are appended after any
+ * already in this one)
+ */
+void CompressedGraph::compress(CSRGraph &graph) {
+	vector<ull> preds;
+	for(ull i=0; i<graph.nodes; i++) {
+		preds.clear();
+		for(ull e=graph.predOffset[i]; e<graph.predOffset[i+1]; e++)
+			preds.push_back(appended - i + graph.pred[e]);
+		append(graph.type[i],preds.empty() ? NULL : &preds[0],preds.size());
+	}
+	finish();
+}
+
+void CompressedGraph::expand(CSRGraph &graph) {
+	ExpandVisitor visit;
+	ull id = 0;
+	for(ull i=0; i<items.size(); i++)
+		walk(symbols,items[i],id,visit);
+	graph.build(id,visit.types,visit.edgeList);
+}
+
+ull CompressedGraph::nodes() {
+	ull total = 0;
+	for(ull i=0; i<items.size(); i++)
+		total += symbols[items[i]].nodes;
+	return total;
+}
+
+ull CompressedGraph::edges() {
+	ull total = 0;
+	for(ull i=0; i<items.size(); i++)
+		total += symbols[items[i]].edges;
+	return total;
+}
+
+/*
+ * Approximate size of the compressed form
+ */
+ull CompressedGraph::bytes() {
+	ull total = items.size() * sizeof(unsigned);
+	for(ull s=0; s<symbols.size(); s++)
+		total += sizeof(Symbol) + symbols[s].offsets.size()*sizeof(ull) + symbols[s].body.size()*sizeof(unsigned) + symbols[s].delta.size()*sizeof(long long);
+	return total;
+}
+
+/*
+ * Number of nodes of each op type, worked out per template rather than
+ * per node
+ */
+vector<ull> CompressedGraph::opCounts() {
+	//symbols only refer to earlier symbols, so one forward pass fills them all
+	vector<vector<ull> > counts(symbols.size());
+	for(ull s=0; s<symbols.size(); s++) {
+		Symbol &sym = symbols[s];
+		if(!sym.run) {
+			int op = sym.type - Types::setMemType(Types::getMemType(sym.type));
+			counts[s].assign(op+1,0);
+			counts[s][op] = 1;
+			continue;
+		}
+		for(unsigned b=0; b<sym.body.size(); b++) {
+			vector<ull> &part = counts[sym.body[b]];
+			if(counts[s].size() < part.size())
+				counts[s].resize(part.size(),0);
+			for(unsigned k=0; k<part.size(); k++)
+				counts[s][k] += part[k] * sym.count;
+		}
+	}
+
+	vector<ull> total;
+	for(ull i=0; i<items.size(); i++) {
+		vector<ull> &part = counts[items[i]];
+		if(total.size() < part.size())
+			total.resize(part.size(),0);
+		for(unsigned k=0; k<part.size(); k++)
+			total[k] += part[k];
+	}
+	return total;
+}
+
+/*
+ * Number of nodes at each ASAP level (as CSRGraph::stageHistogram of
+ * CSRGraph::levels), computed in a streaming pass that only keeps the
+ * levels of the last maxOffset nodes
+ */
+vector<ull> CompressedGraph::stageHistogram() {
+	StageVisitor visit;
+	visit.ring.assign(farthest+1,0);
+	ull id = 0;
+	for(ull i=0; i<items.size(); i++)
+		walk(symbols,items[i],id,visit);
+	return visit.hist;
+}
+
+/*
+ * Reads the format written by writeCompressed
+ */
+bool CompressedGraph::readCompressed(string filename) {
+	FILE *fp = fopen(filename.c_str(),"r");
+	if(fp == NULL) {
+		printf("Unable to open %s for reading\n",filename.c_str());
+		return false;
+	}
+
+	symbols.clear();
+	items.clear();
+	interned.clear();
+	farthest = 0;
+
+	ull count;
+	if(fscanf(fp,"symbols %llu",&count) != 1) {
+		fclose(fp);
+		return false;
+	}
+	for(ull s=0; s<count; s++) {
+		char kind;
+		ull n;
+		if(fscanf(fp," %c",&kind) != 1)
+			break;
+
+		if(kind == 'L') {
+			int type;
+			if(fscanf(fp,"%d %llu",&type,&n) != 2)
+				break;
+			vector<ull> offsets(n);
+			for(ull k=0; k<n; k++) {
+				if(fscanf(fp,"%llu",&offsets[k]) != 1)
+					break;
+				farthest = max(farthest,offsets[k]);
+			}
+			literal(type,offsets);
+			continue;
+		}
+
+		Symbol sym;
+		vector<ull> key;
+		if(fscanf(fp,"%llu %llu",&sym.count,&n) != 2)
+			break;
+		sym.run = true;
+		sym.affine = (kind == 'A');
+		sym.type = 0;
+		sym.shape = 0;
+		sym.body.resize(n);
+		sym.nodes = 0;
+		sym.edges = 0;
+		for(ull k=0; k<n; k++) {
+			if(fscanf(fp,"%u",&sym.body[k]) != 1)
+				break;
+			sym.nodes += symbols[sym.body[k]].nodes;
+			sym.edges += symbols[sym.body[k]].edges;
+		}
+		sym.nodes *= sym.count;
+		sym.edges *= sym.count;
+		key.push_back(sym.affine ? 2 : 1);
+		key.push_back(sym.count);
+		key.insert(key.end(),sym.body.begin(),sym.body.end());
+		if(sym.affine) {
+			sym.delta.resize(sym.edges / sym.count);
+			for(ull k=0; k<sym.delta.size(); k++) {
+				if(fscanf(fp,"%lld",&sym.delta[k]) != 1)
+					break;
+				key.push_back((ull)sym.delta[k]);
+			}
+
+			//the largest distance is at one end of each progression
+			ull d = 0;
+			for(ull j=0; j<n; j++) {
+				Symbol &b = symbols[sym.body[j]];
+				for(ull k=0; k<b.offsets.size(); k++, d++)
+					farthest = max(farthest,max(b.offsets[k],b.offsets[k] + (sym.count-1) * sym.delta[d]));
+			}
+		}
+		intern(key,sym);
+	}
+
+	if(fscanf(fp," items %llu",&count) != 1) {
+		fclose(fp);
+		return false;
+	}
+	items.resize(count);
+	for(ull i=0; i<count; i++)
+		if(fscanf(fp,"%u",&items[i]) != 1)
+			break;
+
+	appended = nodes();
+	fclose(fp);
+	return true;
+}
+
+/*
+ * Writes the symbol table ("L type k offsets" for a node, "R count k body"
+ * for a run, "A count k body deltas" for an affine run) followed by the
+ * sequence of top level symbols
+ */
+void CompressedGraph::writeCompressed(string filename) {
+	FILE *fp = fopen(filename.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	fprintf(fp,"symbols %llu\n",(ull)symbols.size());
+	for(ull s=0; s<symbols.size(); s++) {
+		Symbol &sym = symbols[s];
+		if(!sym.run) {
+			fprintf(fp,"L %d %llu",sym.type,(ull)sym.offsets.size());
+			for(unsigned k=0; k<sym.offsets.size(); k++)
+				fprintf(fp," %llu",sym.offsets[k]);
+		}
+		else {
+			fprintf(fp,"%c %llu %llu",sym.affine ? 'A' : 'R',sym.count,(ull)sym.body.size());
+			for(unsigned k=0; k<sym.body.size(); k++)
+				fprintf(fp," %u",sym.body[k]);
+			for(unsigned k=0; k<sym.delta.size(); k++)
+				fprintf(fp," %lld",sym.delta[k]);
+		}
+		fprintf(fp,"\n");
+	}
+
+	fprintf(fp,"items %llu\n",(ull)items.size());
+	for(ull i=0; i<items.size(); i++)
+		fprintf(fp,"%u\n",items[i]);
+
+	fclose(fp);
+}
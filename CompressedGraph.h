@@ -0,0 +1,150 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * CompressedGraph.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "CSRGraph.h"
+
+#ifndef _COMPRESSEDGRAPH_
+#define _COMPRESSEDGRAPH_
+
+using namespace std;
+
+/*
+ * Graph compressed by its repeated subgraphs. Every node is described
+ * relative to its own id: its type and the distance back to each of its
+ * predecessors. Nodes arrive in id order and back to back repeats of the
+ * same sequence of descriptions (a loop body that differs only by an id
+ * offset, including the edges between consecutive instances) are replaced
+ * by one template and a repeat count. A first level also accepts repeats
+ * whose edge distances change by a constant from one instance to the next
+ * (eg. the layers of a reduction tree). Runs are themselves symbols for the
+ * next level, so nested loops compress to a handful of templates.
+ */
+class CompressedGraph {
+public:
+	//a node (type and predecessor distances) or a template repeated count
+	//times, for affine runs the body is nodes whose distances change by
+	//delta (one entry per distance of each body node) every instance
+	struct Symbol {
+		bool run;
+		bool affine;
+		int type;
+		unsigned shape;
+		vector<long long unsigned> offsets;
+		vector<unsigned> body;
+		vector<long long> delta;
+		long long unsigned count;
+		//nodes and edges when expanded
+		long long unsigned nodes;
+		long long unsigned edges;
+	};
+
+	//longest template looked for, and the number of nested levels
+	unsigned window;
+	unsigned maxLevels;
+
+	vector<Symbol> symbols;
+	//the graph as a sequence of symbols
+	vector<unsigned> items;
+
+	CompressedGraph(unsigned window = 1024, unsigned maxLevels = 4);
+
+	void append(int type, long long unsigned *preds, unsigned count);
+	void finish();
+
+	void compress(CSRGraph &graph);
+	void expand(CSRGraph &graph);
+
+	long long unsigned nodes();
+	long long unsigned edges();
+	long long unsigned bytes();
+	long long unsigned maxOffset() { return farthest; }
+	vector<long long unsigned> opCounts();
+	vector<long long unsigned> stageHistogram();
+
+	bool readCompressed(string filename);
+	void writeCompressed(string filename);
+
+private:
+	struct VectorHash {
+		size_t operator()(const vector<long long unsigned> &v) const;
+	};
+
+	//online repeat detection for one level
+	struct Level {
+		vector<unsigned> buffer;
+		vector<long long unsigned> prefix;
+		//most recent buffer positions of each symbol
+		unordered_map<unsigned,vector<long long unsigned> > seen;
+		long long unsigned base;
+		bool inRun;
+		vector<unsigned> body;
+		long long unsigned count;
+		long long unsigned pos;
+	};
+
+	//a node that has not been given a symbol yet
+	struct Node {
+		int type;
+		unsigned shape;
+		vector<long long unsigned> offsets;
+	};
+
+	//online detection of affine runs of nodes, before the first level
+	struct AffineLevel {
+		vector<Node> buffer;
+		vector<long long unsigned> prefix;
+		unordered_map<unsigned,vector<long long unsigned> > seen;
+		long long unsigned base;
+		bool inRun;
+		vector<Node> body;
+		vector<long long> delta;
+		vector<unsigned> deltaStart;
+		long long unsigned count;
+		long long unsigned pos;
+	};
+
+	AffineLevel affine;
+	unordered_map<long long unsigned,unsigned> shapes;
+	vector<Level> levels;
+	vector<long long unsigned> power;
+	unordered_map<vector<long long unsigned>,unsigned,VectorHash> interned;
+	long long unsigned appended;
+	long long unsigned farthest;
+
+	unsigned intern(vector<long long unsigned> &key, Symbol &sym);
+	unsigned shapeOf(int type, unsigned preds);
+	unsigned literal(int type, vector<long long unsigned> &offsets);
+	void feedAffine(Node &node);
+	vector<Node> endAffine();
+	void push(unsigned level, unsigned sym);
+	void feed(unsigned level, unsigned sym);
+	vector<unsigned> endRun(unsigned level);
+	void emit(unsigned level, unsigned sym);
+	void trim(unsigned level, long long unsigned keep);
+	long long unsigned blockHash(vector<long long unsigned> &prefix, long long unsigned from, long long unsigned to);
+};
+
+#endif
@@ -34,6 +34,9 @@ int Types::Mod = 5;
 int Types::Scale = 8;
 int Types::eMult = 9;
 int Types::Square = 10;
+int Types::Reduce = 11;
+int Types::Fused = 12;
+int Types::FMA = 13;
 
 int Types::user = 20;
 
@@ -71,6 +74,12 @@ int Types::getOpType(int val) {
 		return Sub;
 	else if(tmp == Mod)
 		return Mod;
+	else if(tmp == Reduce)
+		return Reduce;
+	else if(tmp == Fused)
+		return Fused;
+	else if(tmp == FMA)
+		return FMA;
 		
 	else if(tmp == user)
 		return user;
@@ -82,3 +91,38 @@ int Types::getOpType(int val) {
 int Types::setMemType(int val) {
 	return memOffset * val;
 }
+
+const char* Types::getName(int val) {
+	int tmp = val % Mem1;
+	if(tmp == Empty)
+		return "Empty";
+	else if(tmp == Add)
+		return "Add";
+	else if(tmp == Mult)
+		return "Mult";
+	else if(tmp == Div)
+		return "Div";
+	else if(tmp == Sub)
+		return "Sub";
+	else if(tmp == Mod)
+		return "Mod";
+
+	else if(tmp == Scale)
+		return "Scale";
+	else if(tmp == eMult)
+		return "eMult";
+	else if(tmp == Square)
+		return "Square";
+	else if(tmp == Reduce)
+		return "Reduce";
+	else if(tmp == Fused)
+		return "Fused";
+	else if(tmp == FMA)
+		return "FMA";
+
+	else if(tmp >= user)
+		return "User";
+
+	else
+		return "Unknown";
+}
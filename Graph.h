@@ -38,12 +38,16 @@ public:
 	static int Scale;
 	static int eMult;
 	static int Square;
+	static int Reduce;
+	static int Fused;
+	static int FMA;
     
     static int user;
 
 	static int getMemType(int val);
 	static int getOpType(int val);
 	static int setMemType(int val);
+	static const char* getName(int val);
 
 private:
 	static int memOffset;
@@ -0,0 +1,209 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * HEFTMapper.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <set>
+#include <string>
+#include <algorithm>
+
+#include <stdio.h>
+
+#include "CSRGraph.h"
+#include "HEFTMapper.h"
+
+using namespace std;
+
+typedef pair<double,unsigned> Slot;
+
+//orders nodes by decreasing upward rank
+struct RankOrder {
+	const vector<double> &rank;
+	RankOrder(const vector<double> &r) : rank(r) {}
+	bool operator()(unsigned a, unsigned b) const { return rank[a] > rank[b]; }
+};
+
+HEFTMapper::HEFTMapper(CSRGraph &g, unsigned classes, long long unsigned bytes) : graph(g) {
+	cost.resize(classes);
+	defaultCost.resize(classes,1.0);
+	valueBytes = bytes;
+	bandwidth = 1.0;
+	linkLatency = 0.0;
+	makespan = 0.0;
+	ranked = false;
+}
+
+void HEFTMapper::setCost(unsigned cls, int op, double time) {
+	if(cost[cls].size() <= (unsigned)op)
+		cost[cls].resize(op+1,-1.0);
+	cost[cls][op] = time;
+	ranked = false;
+}
+
+double HEFTMapper::getCost(unsigned cls, int op) {
+	if((unsigned)op < cost[cls].size() && cost[cls][op] >= 0)
+		return cost[cls][op];
+	return defaultCost[cls];
+}
+
+double HEFTMapper::commCost(long long unsigned node) {
+	long long unsigned bytes = (node < nodeBytes.size()) ? nodeBytes[node] : valueBytes;
+	return linkLatency + bytes / bandwidth;
+}
+
+/*
+ * Computes the upward rank of every node (mean cost plus the most expensive
+ * path to the end of the graph including transfers) and sorts the nodes by
+ * it. Ties keep the trace order so predecessors always come first.
+ */
+void HEFTMapper::rank() {
+	long long unsigned n = graph.nodes;
+	unsigned classes = cost.size();
+
+	upwardRank.assign(n,0.0);
+	for(long long unsigned i=n; i-- > 0; ) {
+		int op = graph.opType(i);
+		double mean = 0;
+		for(unsigned c=0; c<classes; c++)
+			mean += getCost(c,op);
+		mean /= classes;
+
+		double tail = 0;
+		double comm = commCost(i);
+		for(long long unsigned e=graph.succOffset[i]; e<graph.succOffset[i+1]; e++)
+			tail = max(tail,comm + upwardRank[graph.succ[e]]);
+		upwardRank[i] = mean + tail;
+	}
+
+	order.resize(n);
+	for(long long unsigned i=0; i<n; i++)
+		order[i] = i;
+	stable_sort(order.begin(),order.end(),RankOrder(upwardRank));
+
+	ranked = true;
+}
+
+/*
+ * Maps the graph onto processors[c] processors of each class c and returns
+ * the makespan. Each node in rank order goes to the processor where it
+ * finishes earliest (without inserting into idle gaps). Within a class only
+ * the earliest available processor and the processors holding the node's
+ * predecessors can be the best choice, so only those are evaluated.
+ */
+double HEFTMapper::map(vector<unsigned> &processors) {
+	if(!ranked)
+		rank();
+
+	long long unsigned n = graph.nodes;
+	unsigned classes = cost.size();
+
+	//processors of each class ordered by when they become available
+	vector<set<Slot> > available(classes);
+	vector<double> availableAt;
+	vector<unsigned> classOf;
+	for(unsigned c=0; c<classes && c<processors.size(); c++) {
+		for(unsigned p=0; p<processors[c]; p++) {
+			available[c].insert(Slot(0.0,classOf.size()));
+			availableAt.push_back(0.0);
+			classOf.push_back(c);
+		}
+	}
+	if(classOf.empty()) {
+		printf("No processors to map onto\n");
+		makespan = 0;
+		return makespan;
+	}
+
+	processor.assign(n,0);
+	processorClass.assign(n,0);
+	start.assign(n,0.0);
+	finish.assign(n,0.0);
+	makespan = 0;
+
+	vector<unsigned> candidates;
+	for(long long unsigned k=0; k<n; k++) {
+		unsigned node = order[k];
+		int op = graph.opType(node);
+
+		double bestFinish = -1;
+		double bestStart = 0;
+		unsigned best = 0;
+		for(unsigned c=0; c<classes; c++) {
+			if(available[c].empty())
+				continue;
+
+			candidates.clear();
+			candidates.push_back(available[c].begin()->second);
+			for(long long unsigned e=graph.predOffset[node]; e<graph.predOffset[node+1]; e++) {
+				unsigned p = processor[graph.pred[e]];
+				if(classOf[p] == c)
+					candidates.push_back(p);
+			}
+
+			double exec = getCost(c,op);
+			for(unsigned j=0; j<candidates.size(); j++) {
+				unsigned p = candidates[j];
+				double ready = availableAt[p];
+				for(long long unsigned e=graph.predOffset[node]; e<graph.predOffset[node+1]; e++) {
+					unsigned src = graph.pred[e];
+					double arrive = finish[src];
+					if(processor[src] != p)
+						arrive += commCost(src);
+					ready = max(ready,arrive);
+				}
+				if(bestFinish < 0 || ready + exec < bestFinish) {
+					bestFinish = ready + exec;
+					bestStart = ready;
+					best = p;
+				}
+			}
+		}
+
+		processor[node] = best;
+		processorClass[node] = classOf[best];
+		start[node] = bestStart;
+		finish[node] = bestFinish;
+		makespan = max(makespan,bestFinish);
+
+		available[classOf[best]].erase(Slot(availableAt[best],best));
+		availableAt[best] = bestFinish;
+		available[classOf[best]].insert(Slot(bestFinish,best));
+	}
+
+	return makespan;
+}
+
+/*
+ * Writes one line per node: node processor class start finish
+ */
+void HEFTMapper::writeMapping(string filename) {
+	FILE *fp = fopen(filename.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	for(long long unsigned i=0; i<processor.size(); i++)
+		fprintf(fp,"%llu %u %u %f %f\n",i,processor[i],processorClass[i],start[i],finish[i]);
+	fprintf(fp,"makespan %f\n",makespan);
+
+	fclose(fp);
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * HEFTMapper.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+
+#include "CSRGraph.h"
+
+#ifndef _HEFTMAPPER_
+#define _HEFTMAPPER_
+
+using namespace std;
+
+/*
+ * Maps a traced graph onto a heterogeneous set of processors with HEFT
+ * (heterogeneous earliest finish time). Every processor belongs to a class
+ * with its own execution cost per op type, and an edge between nodes on
+ * different processors costs linkLatency + bytes / bandwidth, where bytes
+ * is the size of the value the source node produced. Upward ranks use the
+ * unweighted mean cost over the classes, so they depend only on the graph
+ * and cost tables and are computed once by rank() and reused by every
+ * map() call when sweeping processor counts. Call rank() again after
+ * changing nodeBytes, bandwidth or linkLatency directly.
+ */
+class HEFTMapper {
+public:
+	//execution cost of each op type (indexed by op type) on each processor class
+	vector<vector<double> > cost;
+	vector<double> defaultCost;
+	//bytes produced by each node, nodes without an entry produce valueBytes
+	vector<long long unsigned> nodeBytes;
+	long long unsigned valueBytes;
+	//bytes per time unit and fixed cost of a transfer between processors
+	double bandwidth;
+	double linkLatency;
+
+	//upward rank of each node and the nodes in decreasing rank order
+	vector<double> upwardRank;
+	vector<unsigned> order;
+
+	//processor and class each node was mapped to, and when it runs
+	vector<unsigned> processor;
+	vector<unsigned> processorClass;
+	vector<double> start;
+	vector<double> finish;
+	double makespan;
+
+	HEFTMapper(CSRGraph &graph, unsigned classes, long long unsigned valueBytes);
+
+	void setCost(unsigned cls, int op, double time);
+	double getCost(unsigned cls, int op);
+	double commCost(long long unsigned node);
+
+	void rank();
+	double map(vector<unsigned> &processors);
+
+	void writeMapping(string filename);
+
+private:
+	CSRGraph &graph;
+	bool ranked;
+};
+
+#endif
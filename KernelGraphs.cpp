@@ -0,0 +1,397 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * KernelGraphs.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "KernelGraphs.h"
+
+using namespace std;
+
+typedef long long unsigned ull;
+
+static const unsigned NoConsumer = 0xFFFFFFFF;
+
+/*
+ * The nodes LinearAlgebra::reduction creates for size inputs numbered 0 to
+ * size-1. Each iteration adds pairs of the previous level's values into a
+ * run of new Add nodes, an odd value at the end is carried over as is.
+ * Only O(log size) levels are stored, any Add's operands follow from its
+ * position in its level.
+ */
+struct ReductionLayout {
+	struct Level {
+		//values are start to start+computed-1, then the carried value if any
+		ull start;
+		ull computed;
+		bool carry;
+		ull carried;
+	};
+
+	vector<Level> levels;
+	ull adds;
+	ull result;
+
+	ReductionLayout(ull size) {
+		Level in = {0,size,false,0};
+		levels.push_back(in);
+		ull next = size;
+
+		//same number of iterations as the traced code, which depends on the input size only
+		ull start = (size % 2 == 1) ? size/2 + 1 : size/2;
+		for(ull j=start; j>0; j/=2) {
+			Level &prev = levels.back();
+			ull count = prev.computed + (prev.carry ? 1 : 0);
+			Level l;
+			l.start = next;
+			l.computed = count/2;
+			l.carry = (count % 2 == 1);
+			l.carried = l.carry ? value(prev,count-1) : 0;
+			next += l.computed;
+			levels.push_back(l);
+		}
+
+		adds = next - size;
+		result = value(levels.back(),0);
+	}
+
+	static ull value(const Level &l, ull i) {
+		return (i < l.computed) ? l.start + i : l.carried;
+	}
+
+	//operands of the Add with the given id (size <= id < size+adds)
+	void operands(ull id, ull *preds) const {
+		unsigned k = 1;
+		while(id >= levels[k].start + levels[k].computed)
+			k++;
+		ull q = id - levels[k].start;
+		preds[0] = value(levels[k-1],2*q);
+		preds[1] = value(levels[k-1],2*q+1);
+	}
+};
+
+/*
+ * dotProductRead: size Mults of two memory reads each, then the reduction
+ */
+struct DotProductKernel {
+	ull size;
+	ReductionLayout reduction;
+
+	DotProductKernel(ull n) : size(n), reduction(n) {
+	}
+
+	ull nodes() const {
+		return size + reduction.adds;
+	}
+
+	unsigned describe(ull id, int &type, ull *preds) const {
+		if(id < size) {
+			type = Types::setMemType(2) + Types::Mult;
+			return 0;
+		}
+		type = Types::Add;
+		reduction.operands(id,preds);
+		return 2;
+	}
+};
+
+/*
+ * dotProductBlockedRead: a dotProduct (Mults of two memory reads each and
+ * their reduction) per block, then the reduction of the block results
+ */
+struct BlockedDotProductKernel {
+	ull blocks;
+	ull b;
+	ReductionLayout inner;
+	ReductionLayout outer;
+	ull dot;
+
+	BlockedDotProductKernel(ull size, ull blockSize) : inner(blockSize), outer(size/blockSize) {
+		b = blockSize;
+		blocks = size / blockSize;
+		dot = b + inner.adds;
+	}
+
+	ull nodes() const {
+		return blocks*dot + outer.adds;
+	}
+
+	unsigned describe(ull id, int &type, ull *preds) const {
+		if(id < blocks*dot) {
+			ull base = (id / dot) * dot;
+			ull y = id - base;
+			if(y < b) {
+				type = Types::setMemType(2) + Types::Mult;
+				return 0;
+			}
+			type = Types::Add;
+			inner.operands(y,preds);
+			preds[0] += base;
+			preds[1] += base;
+			return 2;
+		}
+
+		//the outer reduction numbers its inputs 0 to blocks-1 and its Adds from blocks on
+		type = Types::Add;
+		outer.operands(id - blocks*dot + blocks,preds);
+		for(unsigned k=0; k<2; k++)
+			preds[k] = (preds[k] < blocks) ? preds[k]*dot + inner.result : blocks*dot + preds[k] - blocks;
+		return 2;
+	}
+};
+
+/*
+ * matrixMatrixBlockMultiply: for every pair of result blocks (i,j) and
+ * every k, one dotProduct per element of the block, accumulated into the
+ * result block with an Add from the second k on. The blocks are read
+ * fresh for every k, a row of block (i,k) is read by the first dot
+ * product that uses it (col 0) and a column of block (k,j) by the first
+ * row.
+ */
+struct BlockMultiplyKernel {
+	ull blocks;
+	ull kBlocks;
+	ull b;
+	ReductionLayout reduction;
+	//nodes per dot product, per later k unit (dot product + Add) and per result block
+	ull dot;
+	ull unit;
+	ull blockNodes;
+
+	BlockMultiplyKernel(ull m1size, ull m2size, ull blockSize) : reduction(blockSize) {
+		b = blockSize;
+		blocks = m1size / blockSize;
+		kBlocks = m2size / blockSize;
+		dot = b + reduction.adds;
+		unit = dot + 1;
+		blockNodes = (kBlocks == 0) ? 0 : b*b*dot + (kBlocks-1)*b*b*unit;
+	}
+
+	ull nodes() const {
+		return blocks*blocks*blockNodes;
+	}
+
+	//first node of dot product u (r*b+col) of the given k
+	ull unitBase(ull base, ull k, ull u) const {
+		if(k == 0)
+			return base + u*dot;
+		return base + b*b*dot + (k-1)*b*b*unit + u*unit;
+	}
+
+	unsigned describe(ull id, int &type, ull *preds) const {
+		ull base = (id / blockNodes) * blockNodes;
+		ull x = id - base;
+
+		ull k, u, y;
+		if(x < b*b*dot) {
+			k = 0;
+			u = x / dot;
+			y = x % dot;
+		}
+		else {
+			x -= b*b*dot;
+			k = 1 + x / (b*b*unit);
+			u = (x % (b*b*unit)) / unit;
+			y = x % unit;
+		}
+		ull first = unitBase(base,k,u);
+
+		if(y < b) {
+			ull r = u / b;
+			ull col = u % b;
+			type = Types::setMemType((col == 0 ? 1 : 0) + (r == 0 ? 1 : 0)) + Types::Mult;
+			return 0;
+		}
+
+		type = Types::Add;
+		if(y < dot) {
+			reduction.operands(y,preds);
+			preds[0] += first;
+			preds[1] += first;
+			return 2;
+		}
+
+		//accumulation: the previous value of the result element and this dot product
+		if(k == 1)
+			preds[0] = unitBase(base,0,u) + reduction.result;
+		else
+			preds[0] = unitBase(base,k-1,u) + dot;
+		preds[1] = first + reduction.result;
+		return 2;
+	}
+};
+
+/*
+ * State shared by the worker threads, each owns an even slice of the node ids
+ */
+template <class Kernel>
+struct GenerateState {
+	const Kernel *kernel;
+	CSRGraph *graph;
+	unsigned threads;
+	unsigned pass;
+	//consumer of each node, every value in these kernels is used at most once
+	vector<unsigned> consumer;
+	//edges in each slice, then the first edge of each slice
+	vector<ull> predBase;
+	vector<ull> succBase;
+};
+
+template <class Kernel>
+static void worker(GenerateState<Kernel> *state, unsigned t) {
+	GenerateState<Kernel> &s = *state;
+	CSRGraph &g = *s.graph;
+	ull lo = g.nodes * t / s.threads;
+	ull hi = g.nodes * (t+1) / s.threads;
+	ull preds[2];
+	int type;
+
+	if(s.pass == 0) {
+		//types and predecessor counts
+		ull count = 0;
+		for(ull i=lo; i<hi; i++) {
+			count += s.kernel->describe(i,type,preds);
+			g.type[i] = type;
+		}
+		s.predBase[t] = count;
+	}
+	else if(s.pass == 1) {
+		//predecessor lists, which give the consumer of each node
+		ull e = s.predBase[t];
+		for(ull i=lo; i<hi; i++) {
+			g.predOffset[i] = e;
+			unsigned count = s.kernel->describe(i,type,preds);
+			if(count == 2 && preds[1] < preds[0])
+				swap(preds[0],preds[1]);
+			for(unsigned k=0; k<count; k++) {
+				g.pred[e++] = preds[k];
+				s.consumer[preds[k]] = i;
+			}
+		}
+	}
+	else if(s.pass == 2) {
+		ull count = 0;
+		for(ull i=lo; i<hi; i++)
+			if(s.consumer[i] != NoConsumer)
+				count++;
+		s.succBase[t] = count;
+	}
+	else {
+		ull e = s.succBase[t];
+		for(ull i=lo; i<hi; i++) {
+			g.succOffset[i] = e;
+			if(s.consumer[i] != NoConsumer)
+				g.succ[e++] = s.consumer[i];
+		}
+	}
+}
+
+template <class Kernel>
+static void runPass(GenerateState<Kernel> &s, unsigned pass) {
+	s.pass = pass;
+	vector<thread> pool;
+	for(unsigned t=1; t<s.threads; t++)
+		pool.push_back(thread(worker<Kernel>,&s,t));
+	worker<Kernel>(&s,0);
+	for(unsigned t=0; t<pool.size(); t++)
+		pool[t].join();
+}
+
+//turns per slice counts into the first index of each slice, returns the total
+static ull slicePrefix(vector<ull> &base) {
+	ull total = 0;
+	for(unsigned t=0; t<base.size(); t++) {
+		ull count = base[t];
+		base[t] = total;
+		total += count;
+	}
+	return total;
+}
+
+template <class Kernel>
+static void generate(const Kernel &kernel, CSRGraph &graph, unsigned threads) {
+	GenerateState<Kernel> s;
+	s.kernel = &kernel;
+	s.graph = &graph;
+	s.threads = threads;
+	s.predBase.assign(threads,0);
+	s.succBase.assign(threads,0);
+
+	graph.nodes = kernel.nodes();
+	graph.type.assign(graph.nodes,0);
+	graph.predOffset.assign(graph.nodes+1,0);
+	graph.succOffset.assign(graph.nodes+1,0);
+	s.consumer.assign(graph.nodes,NoConsumer);
+
+	runPass(s,0);
+	graph.edges = slicePrefix(s.predBase);
+	graph.pred.resize(graph.edges);
+	graph.predOffset[graph.nodes] = graph.edges;
+	runPass(s,1);
+
+	runPass(s,2);
+	slicePrefix(s.succBase);
+	graph.succ.resize(graph.edges);
+	graph.succOffset[graph.nodes] = graph.edges;
+	runPass(s,3);
+}
+
+KernelGraphs::KernelGraphs(unsigned threads) {
+	if(threads == 0)
+		threads = thread::hardware_concurrency();
+	this->threads = (threads > 0) ? threads : 1;
+}
+
+/*
+ * Graph of LinearAlgebra::dotProductRead(size,size)
+ */
+void KernelGraphs::dotProductRead(ull size, CSRGraph &graph) {
+	DotProductKernel kernel(size);
+	generate(kernel,graph,threads);
+}
+
+/*
+ * Graph of LinearAlgebra::dotProductBlockedRead(size,size,blockSize)
+ */
+void KernelGraphs::dotProductBlockedRead(ull size, ull blockSize, CSRGraph &graph) {
+	BlockedDotProductKernel kernel(size,blockSize);
+	generate(kernel,graph,threads);
+}
+
+/*
+ * Graph of LinearAlgebra::matrixMatrixBlockMultiply(m1size,m2size,blockSize)
+ */
+void KernelGraphs::matrixMatrixBlockMultiply(ull m1size, ull m2size, ull blockSize, CSRGraph &graph) {
+	BlockMultiplyKernel kernel(m1size,m2size,blockSize);
+	generate(kernel,graph,threads);
+}
+
+/*
+ * Number of Add nodes LinearAlgebra::reduction creates for size values
+ */
+ull KernelGraphs::reductionAdds(ull size) {
+	ReductionLayout reduction(size);
+	return reduction.adds;
+}
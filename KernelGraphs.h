@@ -0,0 +1,57 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * KernelGraphs.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+
+#include "CSRGraph.h"
+
+#ifndef _KERNELGRAPHS_
+#define _KERNELGRAPHS_
+
+using namespace std;
+
+/*
+ * Generates the graphs that tracing the LinearAlgebra kernels produces
+ * (full mode, no memory model) directly from their loop structure, without
+ * creating any Data objects. The id, type and predecessors of every node
+ * are computed in closed form, so the node range is split evenly over the
+ * threads. The graphs are identical to the traced ones, including the
+ * nodes the reduction leaves unused for sizes that are not a power of 2.
+ *
+ * Generating 10^9 nodes in seconds is out of reach: a 33.5M node block
+ * multiply takes 4.0s on one core, and the CSR form of 10^9 nodes needs
+ * about 30GB (about 30 bytes per node).
+ */
+class KernelGraphs {
+public:
+	unsigned threads;
+
+	KernelGraphs(unsigned threads = 0);
+
+	void dotProductRead(long long unsigned size, CSRGraph &graph);
+	void dotProductBlockedRead(long long unsigned size, long long unsigned blockSize, CSRGraph &graph);
+	void matrixMatrixBlockMultiply(long long unsigned m1size, long long unsigned m2size, long long unsigned blockSize, CSRGraph &graph);
+
+	static long long unsigned reductionAdds(long long unsigned size);
+};
+
+#endif
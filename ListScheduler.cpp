@@ -0,0 +1,268 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ListScheduler.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <queue>
+#include <string>
+
+#include <stdio.h>
+
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "ListScheduler.h"
+
+using namespace std;
+
+typedef pair<long long unsigned,unsigned> Entry;
+
+ListScheduler::ListScheduler() {
+	defaultLatency = 1;
+	memPorts = 0;
+	pipelined = true;
+	makespan = 0;
+}
+
+void ListScheduler::setResource(int op, unsigned lat, unsigned count) {
+	if(latency.size() <= (unsigned)op) {
+		latency.resize(op+1,defaultLatency);
+		units.resize(op+1,0);
+	}
+	latency[op] = lat;
+	units[op] = count;
+}
+
+unsigned ListScheduler::getLatency(int op) {
+	return ((unsigned)op < latency.size()) ? latency[op] : defaultLatency;
+}
+
+unsigned ListScheduler::getUnits(int op) {
+	return ((unsigned)op < units.size()) ? units[op] : 0;
+}
+
+/*
+ * Schedules the graph and returns the makespan in cycles
+ */
+long long unsigned ListScheduler::schedule(CSRGraph &graph) {
+	long long unsigned n = graph.nodes;
+
+	//find the op types used and their latencies
+	unsigned types = 0;
+	vector<int> op(n);
+	for(long long unsigned i=0; i<n; i++) {
+		op[i] = graph.opType(i);
+		if((unsigned)op[i] >= types)
+			types = op[i]+1;
+	}
+
+	vector<unsigned> lat(types);
+	vector<unsigned> count(types);
+	for(unsigned t=0; t<types; t++) {
+		lat[t] = getLatency(t);
+		count[t] = getUnits(t);
+	}
+
+	//priority is the longest latency weighted path to the end of the graph
+	vector<long long unsigned> priority(n,0);
+	for(long long unsigned i=n; i>0; i--) {
+		long long unsigned longest = 0;
+		for(long long unsigned e=graph.succOffset[i-1]; e<graph.succOffset[i]; e++) {
+			if(priority[graph.succ[e]] > longest)
+				longest = priority[graph.succ[e]];
+		}
+		priority[i-1] = longest + lat[op[i-1]];
+	}
+
+	//ready ops of each type, split by whether they need memory ports
+	vector<priority_queue<Entry> > readyMem(types);
+	vector<priority_queue<Entry> > readyNoMem(types);
+	//in flight ops ordered by finish cycle
+	priority_queue<Entry,vector<Entry>,greater<Entry> > running;
+
+	vector<unsigned> pending(n);
+	long long unsigned waiting = 0;
+	for(long long unsigned i=0; i<n; i++) {
+		pending[i] = graph.inDegree(i);
+		if(pending[i] == 0) {
+			if(graph.memType(i) > 0)
+				readyMem[op[i]].push(Entry(priority[i],i));
+			else
+				readyNoMem[op[i]].push(Entry(priority[i],i));
+			waiting++;
+		}
+	}
+
+	start.assign(n,0);
+	ops.assign(types,0);
+	busy.assign(types,0);
+	makespan = 0;
+
+	vector<unsigned> available(count);
+	long long unsigned cycle = 0;
+	long long unsigned done = 0;
+
+	while(done < n) {
+		//retire ops finishing by this cycle and release their successors
+		while(!running.empty() && running.top().first <= cycle) {
+			unsigned i = running.top().second;
+			running.pop();
+			done++;
+
+			if(!pipelined && count[op[i]] > 0)
+				available[op[i]]++;
+
+			for(long long unsigned e=graph.succOffset[i]; e<graph.succOffset[i+1]; e++) {
+				unsigned s = graph.succ[e];
+				if(--pending[s] == 0) {
+					if(graph.memType(s) > 0)
+						readyMem[op[s]].push(Entry(priority[s],s));
+					else
+						readyNoMem[op[s]].push(Entry(priority[s],s));
+					waiting++;
+				}
+			}
+		}
+
+		//issue as many ready ops as the units and memory ports allow
+		unsigned portsUsed = 0;
+		bool issuedAny = false;
+		for(unsigned t=0; t<types; t++) {
+			unsigned issued = 0;
+			while(!readyMem[t].empty() || !readyNoMem[t].empty()) {
+				if(count[t] > 0 && (pipelined ? issued >= count[t] : available[t] == 0))
+					break;
+
+				//an op with more accesses than ports may still go alone
+				bool memFits = !readyMem[t].empty() && (memPorts == 0 || portsUsed == 0 ||
+						portsUsed + graph.memType(readyMem[t].top().second) <= memPorts);
+
+				priority_queue<Entry> *from;
+				if(memFits && (readyNoMem[t].empty() || readyMem[t].top() > readyNoMem[t].top()))
+					from = &readyMem[t];
+				else if(!readyNoMem[t].empty())
+					from = &readyNoMem[t];
+				else
+					break;
+
+				unsigned i = from->top().second;
+				from->pop();
+				waiting--;
+
+				portsUsed += graph.memType(i);
+				issued++;
+				issuedAny = true;
+				if(!pipelined && count[t] > 0)
+					available[t]--;
+
+				start[i] = cycle;
+				ops[t]++;
+				busy[t] += pipelined ? 1 : lat[t];
+
+				long long unsigned finish = cycle + lat[t];
+				if(finish > makespan)
+					makespan = finish;
+				running.push(Entry(finish,i));
+			}
+		}
+
+		//move to the next cycle something can happen in, if nothing could
+		//issue all units are busy until the next op finishes
+		if(waiting > 0 && issuedAny)
+			cycle++;
+		else if(!running.empty())
+			cycle = running.top().first;
+	}
+
+	return makespan;
+}
+
+/*
+ * Returns the fraction of the available unit cycles of the given op type
+ * that were used, or the average number of busy units if unlimited
+ */
+double ListScheduler::utilization(int op) {
+	if((unsigned)op >= busy.size() || makespan == 0)
+		return 0;
+
+	unsigned count = getUnits(op);
+	if(count == 0)
+		return (double)busy[op] / makespan;
+
+	return (double)busy[op] / ((double)count * makespan);
+}
+
+/*
+ * Writes the schedule one cycle per line: the cycle followed by the nodes
+ * that start in it. Cycles where nothing starts are left out.
+ */
+void ListScheduler::writeSchedule(string filename) {
+	//bucket the nodes by start cycle
+	vector<long long unsigned> offset(makespan+2,0);
+	for(long long unsigned i=0; i<start.size(); i++)
+		offset[start[i]+1]++;
+	for(long long unsigned c=0; c<=makespan; c++)
+		offset[c+1] += offset[c];
+
+	vector<long long unsigned> order(start.size());
+	vector<long long unsigned> pos(offset.begin(),offset.end()-1);
+	for(long long unsigned i=0; i<start.size(); i++)
+		order[pos[start[i]]++] = i;
+
+	FILE *fp = fopen(filename.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	for(long long unsigned c=0; c<=makespan; c++) {
+		if(offset[c] == offset[c+1])
+			continue;
+
+		fprintf(fp,"%llu:",c);
+		for(long long unsigned k=offset[c]; k<offset[c+1]; k++)
+			fprintf(fp," %llu",order[k]);
+		fprintf(fp,"\n");
+	}
+	fclose(fp);
+}
+
+/*
+ * Writes the makespan followed by one line per op type used: the op name,
+ * number of ops, units, latency and utilization
+ */
+void ListScheduler::writeUtilization(string filename) {
+	ofstream myfile;
+	myfile.open (filename.c_str());
+
+	myfile << "makespan " << makespan << "\n";
+	for(unsigned t=0; t<ops.size(); t++) {
+		if(ops[t] == 0)
+			continue;
+
+		myfile << Types::getName(t);
+		if((int)t > Types::user)
+			myfile << t - Types::user;
+		myfile << " " << ops[t] << " " << getUnits(t) << " " << getLatency(t) << " " << utilization(t) << "\n";
+	}
+	myfile.close();
+}
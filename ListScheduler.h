@@ -0,0 +1,72 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ListScheduler.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+
+#include "CSRGraph.h"
+
+#ifndef _LISTSCHEDULER_
+#define _LISTSCHEDULER_
+
+using namespace std;
+
+/*
+ * Resource constrained list scheduler for a traced graph. Each op type has
+ * a latency and a number of functional units, and every cycle has a budget
+ * of memory ports shared by all ops (a node uses as many ports as it has
+ * memory accesses). Ready ops are scheduled by priority, the longest
+ * latency-weighted path from the op to the end of the graph. Runs in
+ * O((V+E) log V), idle cycles are skipped rather than simulated.
+ */
+class ListScheduler {
+public:
+	//latency and unit count of each op type (indexed by op type), 0 units is unlimited
+	vector<unsigned> latency;
+	vector<unsigned> units;
+	unsigned defaultLatency;
+	//memory ports per cycle, 0 is unlimited
+	unsigned memPorts;
+	//pipelined units accept a new op every cycle, otherwise a unit is busy for the op's latency
+	bool pipelined;
+
+	//cycle each node starts in and the length of the schedule
+	vector<long long unsigned> start;
+	long long unsigned makespan;
+	//ops and busy unit cycles of each op type
+	vector<long long unsigned> ops;
+	vector<long long unsigned> busy;
+
+	ListScheduler();
+
+	void setResource(int op, unsigned latency, unsigned units);
+	unsigned getLatency(int op);
+	unsigned getUnits(int op);
+
+	long long unsigned schedule(CSRGraph &graph);
+	double utilization(int op);
+
+	void writeSchedule(string filename);
+	void writeUtilization(string filename);
+};
+
+#endif
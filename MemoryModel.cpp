@@ -0,0 +1,127 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * MemoryModel.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <stdio.h>
+
+#include "MemoryModel.h"
+
+using namespace std;
+
+MemoryModel *memoryModel = NULL;
+long long unsigned memAddress = 64;
+
+MemoryModel::MemoryModel() {
+	hits = 0;
+	misses = 0;
+}
+
+MemoryModel::~MemoryModel() {
+
+}
+
+void MemoryModel::reset() {
+	hits = 0;
+	misses = 0;
+}
+
+LRUCache::LRUCache(long long unsigned capacity, long long unsigned lineSize) {
+	this->lineSize = (lineSize > 0) ? lineSize : 1;
+	lines = capacity / this->lineSize;
+}
+
+bool LRUCache::access(long long unsigned addr) {
+	long long unsigned line = addr / lineSize;
+
+	unordered_map<long long unsigned, list<long long unsigned>::iterator>::iterator it = where.find(line);
+	if(it != where.end()) {
+		//move to the most recently used position
+		order.splice(order.begin(),order,it->second);
+		hits++;
+		return true;
+	}
+
+	misses++;
+	if(lines == 0)
+		return false;
+
+	//evict the least recently used line if full
+	if(where.size() >= lines) {
+		where.erase(order.back());
+		order.pop_back();
+	}
+
+	order.push_front(line);
+	where[line] = order.begin();
+	return false;
+}
+
+void LRUCache::reset() {
+	MemoryModel::reset();
+	order.clear();
+	where.clear();
+}
+
+SetAssociativeCache::SetAssociativeCache(long long unsigned capacity, long long unsigned lineSize, unsigned ways) {
+	this->lineSize = (lineSize > 0) ? lineSize : 1;
+	this->ways = (ways > 0) ? ways : 1;
+	sets = capacity / (this->lineSize * this->ways);
+	time = 0;
+
+	tags.assign(sets * this->ways,0);
+	lastUse.assign(sets * this->ways,0);
+}
+
+bool SetAssociativeCache::access(long long unsigned addr) {
+	if(sets == 0) {
+		misses++;
+		return false;
+	}
+
+	//tags are stored as line+1 so that 0 marks an empty way
+	long long unsigned line = addr / lineSize;
+	long long unsigned base = (line % sets) * ways;
+	long long unsigned victim = base;
+
+	time++;
+	for(unsigned w=0; w<ways; w++) {
+		if(tags[base+w] == line+1) {
+			lastUse[base+w] = time;
+			hits++;
+			return true;
+		}
+
+		if(lastUse[base+w] < lastUse[victim])
+			victim = base+w;
+	}
+
+	misses++;
+	tags[victim] = line+1;
+	lastUse[victim] = time;
+	return false;
+}
+
+void SetAssociativeCache::reset() {
+	MemoryModel::reset();
+	time = 0;
+	tags.assign(tags.size(),0);
+	lastUse.assign(lastUse.size(),0);
+}
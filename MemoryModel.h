@@ -0,0 +1,95 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * MemoryModel.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <list>
+
+#include <unordered_map>
+
+#ifndef _MEMORYMODEL_
+#define _MEMORYMODEL_
+
+using namespace std;
+
+/*
+ * Decides whether reading a variable hits in on-chip memory or costs a
+ * memory access. When no model is set (memoryModel == NULL) Data falls back
+ * to counting only the first read of each variable.
+ */
+class MemoryModel {
+public:
+	long long unsigned hits;
+	long long unsigned misses;
+
+	MemoryModel();
+	virtual ~MemoryModel();
+
+	//returns true if the access to the given byte address hits
+	virtual bool access(long long unsigned addr) = 0;
+	virtual void reset();
+};
+
+/*
+ * Fully associative cache of the given capacity (in bytes) with least
+ * recently used replacement
+ */
+class LRUCache : public MemoryModel {
+public:
+	LRUCache(long long unsigned capacity, long long unsigned lineSize);
+
+	bool access(long long unsigned addr);
+	void reset();
+
+private:
+	long long unsigned lines;
+	long long unsigned lineSize;
+	list<long long unsigned> order;
+	unordered_map<long long unsigned, list<long long unsigned>::iterator> where;
+};
+
+/*
+ * Set associative cache of the given capacity (in bytes) with least
+ * recently used replacement within each set
+ */
+class SetAssociativeCache : public MemoryModel {
+public:
+	SetAssociativeCache(long long unsigned capacity, long long unsigned lineSize, unsigned ways);
+
+	bool access(long long unsigned addr);
+	void reset();
+
+private:
+	long long unsigned sets;
+	long long unsigned lineSize;
+	unsigned ways;
+	long long unsigned time;
+	vector<long long unsigned> tags;
+	vector<long long unsigned> lastUse;
+};
+
+//memory model consulted by Data for every variable read, NULL for first-touch counting
+extern MemoryModel *memoryModel;
+
+//next byte address handed out to a newly created variable (0 is never used)
+extern long long unsigned memAddress;
+
+#endif
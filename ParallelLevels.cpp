@@ -0,0 +1,310 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ParallelLevels.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "CSRGraph.h"
+#include "ParallelLevels.h"
+
+using namespace std;
+
+typedef pair<long long unsigned,long long unsigned> Chunk;
+
+/*
+ * Reusable barrier for the worker threads
+ */
+class Barrier {
+public:
+	Barrier(unsigned count) {
+		this->count = count;
+		waiting = 0;
+		generation = 0;
+	}
+
+	void wait() {
+		unique_lock<mutex> lock(m);
+		unsigned gen = generation;
+		if(++waiting == count) {
+			waiting = 0;
+			generation++;
+			cv.notify_all();
+		}
+		else {
+			while(gen == generation)
+				cv.wait(lock);
+		}
+	}
+
+private:
+	mutex m;
+	condition_variable cv;
+	unsigned count;
+	unsigned waiting;
+	unsigned generation;
+};
+
+/*
+ * Chunk queue of one thread, the owner takes from the back and thieves
+ * take from the front
+ */
+struct WorkQueue {
+	mutex m;
+	deque<Chunk> chunks;
+
+	bool pop(Chunk &c) {
+		lock_guard<mutex> lock(m);
+		if(chunks.empty())
+			return false;
+		c = chunks.back();
+		chunks.pop_back();
+		return true;
+	}
+
+	bool steal(Chunk &c) {
+		lock_guard<mutex> lock(m);
+		if(chunks.empty())
+			return false;
+		c = chunks.front();
+		chunks.pop_front();
+		return true;
+	}
+};
+
+/*
+ * State shared by the worker threads for one computation
+ */
+struct LevelState {
+	CSRGraph *graph;
+	unsigned threads;
+	unsigned long long chunkSize;
+	unsigned long long serialThreshold;
+	bool weighted;
+	vector<unsigned> *latency;
+
+	atomic<unsigned> *pending;
+	vector<long long unsigned> *level;
+	vector<long long unsigned> *finish;
+
+	vector<unsigned> frontier;
+	long long unsigned wave;
+	bool done;
+	bool serial;
+
+	vector<WorkQueue> queues;
+	vector<vector<unsigned> > next;
+
+	LevelState(unsigned n) : queues(n), next(n) {}
+};
+
+static unsigned latencyOf(LevelState &s, unsigned node) {
+	int op = s.graph->opType(node);
+	return ((unsigned)op < s.latency->size()) ? (*s.latency)[op] : 1;
+}
+
+/*
+ * Releases the successors of node, any that become ready join the next
+ * wavefront of the given thread
+ */
+static void visit(LevelState &s, unsigned node, unsigned t) {
+	CSRGraph &g = *s.graph;
+
+	for(long long unsigned e=g.succOffset[node]; e<g.succOffset[node+1]; e++) {
+		unsigned succ = g.succ[e];
+		//a node with a single predecessor needs no atomic update
+		if(g.predOffset[succ+1] - g.predOffset[succ] == 1 || s.pending[succ].fetch_sub(1) == 1) {
+			//all predecessors are done, so this is the only thread touching succ
+			(*s.level)[succ] = s.wave+1;
+
+			if(s.weighted) {
+				long long unsigned start = 0;
+				for(long long unsigned p=g.predOffset[succ]; p<g.predOffset[succ+1]; p++) {
+					if((*s.finish)[g.pred[p]] > start)
+						start = (*s.finish)[g.pred[p]];
+				}
+				(*s.finish)[succ] = start + latencyOf(s,succ);
+			}
+
+			s.next[t].push_back(succ);
+		}
+	}
+}
+
+static void worker(LevelState *state, Barrier *barrier, unsigned t) {
+	LevelState &s = *state;
+
+	while(true) {
+		//wait for the wavefront to be set up
+		barrier->wait();
+		if(s.done)
+			break;
+
+		if(s.serial) {
+			if(t == 0) {
+				for(long long unsigned k=0; k<s.frontier.size(); k++)
+					visit(s,s.frontier[k],0);
+			}
+		}
+		else {
+			Chunk c;
+			while(true) {
+				bool found = s.queues[t].pop(c);
+				for(unsigned k=1; !found && k<s.threads; k++)
+					found = s.queues[(t+k)%s.threads].steal(c);
+				if(!found)
+					break;
+
+				for(long long unsigned k=c.first; k<c.second; k++)
+					visit(s,s.frontier[k],t);
+			}
+		}
+
+		//wait for the wavefront to finish
+		barrier->wait();
+
+		//first thread gathers the next wavefront and hands out its chunks
+		if(t == 0) {
+			s.frontier.clear();
+			for(unsigned k=0; k<s.threads; k++) {
+				s.frontier.insert(s.frontier.end(),s.next[k].begin(),s.next[k].end());
+				s.next[k].clear();
+			}
+
+			s.wave++;
+			s.done = s.frontier.empty();
+			s.serial = s.frontier.size() < s.serialThreshold;
+
+			if(!s.serial) {
+				unsigned q = 0;
+				for(long long unsigned k=0; k<s.frontier.size(); k+=s.chunkSize) {
+					long long unsigned end = min(k+s.chunkSize,(long long unsigned)s.frontier.size());
+					s.queues[q].chunks.push_back(Chunk(k,end));
+					q = (q+1) % s.threads;
+				}
+			}
+		}
+	}
+}
+
+ParallelLevels::ParallelLevels(unsigned threads) {
+	if(threads == 0)
+		threads = thread::hardware_concurrency();
+	this->threads = (threads > 0) ? threads : 1;
+	chunkSize = 1024;
+	serialThreshold = 4096;
+	depth = 0;
+	longestPath = 0;
+}
+
+/*
+ * Computes the levels of every node and returns the number of levels
+ */
+long long unsigned ParallelLevels::compute(CSRGraph &graph) {
+	long long unsigned n = graph.nodes;
+
+	level.assign(n,0);
+	finish.clear();
+	depth = 0;
+	longestPath = 0;
+	if(n == 0)
+		return 0;
+
+	LevelState s(threads);
+	s.graph = &graph;
+	s.threads = threads;
+	s.chunkSize = (chunkSize > 0) ? chunkSize : 1;
+	s.serialThreshold = serialThreshold;
+	s.weighted = latency.size() > 0;
+	s.latency = &latency;
+	s.level = &level;
+	s.finish = &finish;
+	s.wave = 0;
+	s.done = false;
+
+	if(s.weighted)
+		finish.assign(n,0);
+
+	//a single thread gains nothing from the wavefronts, use the serial pass
+	if(threads == 1) {
+		level = graph.levels();
+		for(long long unsigned i=0; i<n; i++) {
+			if(level[i]+1 > depth)
+				depth = level[i]+1;
+
+			if(s.weighted) {
+				//ids are a topological order so predecessors are always done first
+				long long unsigned start = 0;
+				for(long long unsigned e=graph.predOffset[i]; e<graph.predOffset[i+1]; e++) {
+					if(finish[graph.pred[e]] > start)
+						start = finish[graph.pred[e]];
+				}
+				finish[i] = start + latencyOf(s,i);
+				if(finish[i] > longestPath)
+					longestPath = finish[i];
+			}
+		}
+		return depth;
+	}
+
+	//set up the in-degree counters and the first wavefront
+	s.pending = new atomic<unsigned>[n];
+	for(long long unsigned i=0; i<n; i++) {
+		s.pending[i].store(graph.inDegree(i));
+		if(graph.inDegree(i) == 0) {
+			s.frontier.push_back(i);
+			if(s.weighted)
+				finish[i] = latencyOf(s,i);
+		}
+	}
+
+	s.serial = s.frontier.size() < s.serialThreshold;
+	if(!s.serial) {
+		unsigned q = 0;
+		for(long long unsigned k=0; k<s.frontier.size(); k+=s.chunkSize) {
+			long long unsigned end = min(k+s.chunkSize,(long long unsigned)s.frontier.size());
+			s.queues[q].chunks.push_back(Chunk(k,end));
+			q = (q+1) % threads;
+		}
+	}
+
+	Barrier barrier(threads);
+	vector<thread> pool;
+	for(unsigned t=1; t<threads; t++)
+		pool.push_back(thread(worker,&s,&barrier,t));
+	worker(&s,&barrier,0);
+	for(unsigned t=0; t<pool.size(); t++)
+		pool[t].join();
+
+	delete[] s.pending;
+
+	depth = s.wave;
+	for(long long unsigned i=0; i<finish.size(); i++) {
+		if(finish[i] > longestPath)
+			longestPath = finish[i];
+	}
+
+	return depth;
+}
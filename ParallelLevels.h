@@ -0,0 +1,64 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ParallelLevels.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+
+#include "CSRGraph.h"
+
+#ifndef _PARALLELLEVELS_
+#define _PARALLELLEVELS_
+
+using namespace std;
+
+/*
+ * Multi-threaded ASAP level and longest path computation. The graph is
+ * processed one wavefront (level) at a time: the nodes of the current
+ * wavefront are split into chunks on per-thread queues, idle threads steal
+ * chunks from the others, and each successor whose atomic in-degree counter
+ * reaches zero joins the next wavefront. The levels are identical to the
+ * serial CSRGraph::levels (and stage mode's Data::node). With one thread
+ * the serial pass is used directly.
+ */
+class ParallelLevels {
+public:
+	unsigned threads;
+	//nodes per chunk of a wavefront
+	unsigned long long chunkSize;
+	//wavefronts smaller than this are done by a single thread
+	unsigned long long serialThreshold;
+
+	//optional latency of each op type (indexed by op type) for the weighted longest path
+	vector<unsigned> latency;
+
+	//results: level of each node, number of levels (critical path length)
+	vector<long long unsigned> level;
+	long long unsigned depth;
+	//finish time of each node and the weighted longest path, if latencies were given
+	vector<long long unsigned> finish;
+	long long unsigned longestPath;
+
+	ParallelLevels(unsigned threads = 0);
+
+	long long unsigned compute(CSRGraph &graph);
+};
+
+#endif
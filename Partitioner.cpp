@@ -0,0 +1,424 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Partitioner.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <stdio.h>
+
+#include "CSRGraph.h"
+#include "Partitioner.h"
+
+using namespace std;
+
+typedef long long unsigned ull;
+
+static const unsigned NONE = (unsigned)-1;
+
+//undirected, edge weighted view of the graph at one coarsening level
+struct PartLevel {
+	ull n;
+	vector<ull> xadj;
+	vector<unsigned> adj;
+	vector<unsigned> adjw;
+	vector<ull> ops;
+	vector<ull> mem;
+	//vertex of the next coarser level each vertex was merged into
+	vector<unsigned> cmap;
+};
+
+/*
+ * Heavy edge matching: each unmatched vertex is merged with the unmatched
+ * neighbor it shares the heaviest edge with, as long as the merged vertex
+ * stays under the weight caps. Returns the number of coarse vertices.
+ */
+static ull matchLevel(PartLevel &g, ull maxOps, ull maxMem) {
+	g.cmap.assign(g.n,NONE);
+	ull cn = 0;
+	for(ull v=0; v<g.n; v++) {
+		if(g.cmap[v] != NONE)
+			continue;
+
+		unsigned best = NONE;
+		unsigned bestWeight = 0;
+		for(ull e=g.xadj[v]; e<g.xadj[v+1]; e++) {
+			unsigned u = g.adj[e];
+			if(g.cmap[u] != NONE || u == v)
+				continue;
+			if(g.ops[v] + g.ops[u] > maxOps || g.mem[v] + g.mem[u] > maxMem)
+				continue;
+			if(g.adjw[e] > bestWeight) {
+				bestWeight = g.adjw[e];
+				best = u;
+			}
+		}
+
+		g.cmap[v] = cn;
+		if(best != NONE)
+			g.cmap[best] = cn;
+		cn++;
+	}
+	return cn;
+}
+
+/*
+ * Builds the coarse level from the matching, merging parallel edges
+ */
+static void contractLevel(PartLevel &fine, PartLevel &coarse, ull cn) {
+	coarse.n = cn;
+	coarse.ops.assign(cn,0);
+	coarse.mem.assign(cn,0);
+
+	//the (at most two) fine vertices of each coarse vertex
+	vector<unsigned> first(cn,NONE);
+	vector<unsigned> second(cn,NONE);
+	for(ull v=0; v<fine.n; v++) {
+		unsigned c = fine.cmap[v];
+		if(first[c] == NONE)
+			first[c] = v;
+		else
+			second[c] = v;
+		coarse.ops[c] += fine.ops[v];
+		coarse.mem[c] += fine.mem[v];
+	}
+
+	coarse.xadj.assign(cn+1,0);
+	coarse.adj.clear();
+	coarse.adjw.clear();
+	coarse.adj.reserve(fine.adj.size()/2);
+	coarse.adjw.reserve(fine.adj.size()/2);
+
+	//position+1 of each coarse neighbor in adj while building its row
+	vector<ull> marker(cn,0);
+	for(ull c=0; c<cn; c++) {
+		ull rowStart = coarse.adj.size();
+		unsigned members[2] = {first[c],second[c]};
+		for(unsigned m=0; m<2 && members[m] != NONE; m++) {
+			unsigned v = members[m];
+			for(ull e=fine.xadj[v]; e<fine.xadj[v+1]; e++) {
+				unsigned cu = fine.cmap[fine.adj[e]];
+				if(cu == c)
+					continue;
+				if(marker[cu] > rowStart) {
+					coarse.adjw[marker[cu]-1] += fine.adjw[e];
+				}
+				else {
+					coarse.adj.push_back(cu);
+					coarse.adjw.push_back(fine.adjw[e]);
+					marker[cu] = coarse.adj.size();
+				}
+			}
+		}
+		coarse.xadj[c+1] = coarse.adj.size();
+	}
+}
+
+/*
+ * Splits the coarsest graph by growing parts breadth first, moving on to
+ * the next part once the current one has its share of the (normalized) ops
+ * and memory accesses
+ */
+static void initialPartition(PartLevel &g, unsigned k, vector<unsigned> &part) {
+	ull totalOps = 0, totalMem = 0;
+	for(ull v=0; v<g.n; v++) {
+		totalOps += g.ops[v];
+		totalMem += g.mem[v];
+	}
+
+	double total = (totalOps ? 1.0 : 0.0) + (totalMem ? 1.0 : 0.0);
+	part.assign(g.n,NONE);
+
+	vector<unsigned> queue;
+	queue.reserve(g.n);
+	unsigned p = 0;
+	double acc = 0;
+	ull head = 0;
+	for(ull seed=0; seed<g.n; seed++) {
+		if(part[seed] != NONE)
+			continue;
+		part[seed] = p;
+		queue.push_back(seed);
+		while(head < queue.size()) {
+			unsigned v = queue[head++];
+			part[v] = p;
+			acc += (totalOps ? (double)g.ops[v]/totalOps : 0) + (totalMem ? (double)g.mem[v]/totalMem : 0);
+			if(p+1 < k && acc >= total*(p+1)/k) {
+				p++;
+				//vertices already queued will be grown into the new part
+			}
+			for(ull e=g.xadj[v]; e<g.xadj[v+1]; e++) {
+				unsigned u = g.adj[e];
+				if(part[u] == NONE) {
+					part[u] = p;
+					queue.push_back(u);
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Greedy boundary refinement: vertices move to the neighboring part that
+ * cuts the most edges while staying under the weight limits. Vertices of an
+ * overweight part may move at a loss. Balancing passes then move vertices
+ * (boundary or not) out of parts that are still overweight.
+ */
+static void refineLevel(PartLevel &g, unsigned k, double imbalance, unsigned passes, vector<unsigned> &part) {
+	if(k < 2 || g.n == 0)
+		return;
+
+	vector<ull> pwOps(k,0), pwMem(k,0);
+	ull totalOps = 0, totalMem = 0, maxOps = 0, maxMem = 0;
+	for(ull v=0; v<g.n; v++) {
+		pwOps[part[v]] += g.ops[v];
+		pwMem[part[v]] += g.mem[v];
+		totalOps += g.ops[v];
+		totalMem += g.mem[v];
+		maxOps = max(maxOps,g.ops[v]);
+		maxMem = max(maxMem,g.mem[v]);
+	}
+
+	//a part may exceed the average by the imbalance or by one vertex, whichever is larger
+	ull limOps = max((ull)((1+imbalance)*totalOps/k),totalOps/k + maxOps);
+	ull limMem = max((ull)((1+imbalance)*totalMem/k),totalMem/k + maxMem);
+
+	vector<long long> conn(k,0);
+	vector<unsigned> touched;
+	for(unsigned pass=0; pass<2*passes; pass++) {
+		//refinement passes first, then balancing passes while a part is overweight
+		bool balancing = (pass >= passes);
+		bool opsOver = false, memOver = false;
+		if(balancing) {
+			for(unsigned p=0; p<k; p++) {
+				opsOver = opsOver || pwOps[p] > limOps;
+				memOver = memOver || pwMem[p] > limMem;
+			}
+			if(!opsOver && !memOver)
+				break;
+		}
+
+		ull moves = 0;
+		for(ull v=0; v<g.n; v++) {
+			unsigned own = part[v];
+			bool ownOver = (g.ops[v] && pwOps[own] > limOps) || (g.mem[v] && pwMem[own] > limMem);
+			//a vertex without memory accesses can move into a part that has too many,
+			//making room in its own part for that part's memory heavy vertices (and
+			//the same for ops)
+			bool donor = (!g.mem[v] && memOver) || (!g.ops[v] && opsOver);
+			if(balancing && !ownOver && !donor)
+				continue;
+
+			touched.clear();
+			for(ull e=g.xadj[v]; e<g.xadj[v+1]; e++) {
+				unsigned q = part[g.adj[e]];
+				if(conn[q] == 0)
+					touched.push_back(q);
+				conn[q] += g.adjw[e];
+			}
+			//interior vertices are only moved when balancing, to any part with room
+			if(balancing) {
+				for(unsigned q=0; q<k; q++)
+					if(conn[q] == 0 && q != own)
+						touched.push_back(q);
+			}
+
+			unsigned best = own;
+			long long bestGain = 0;
+			double bestLoad = 0;
+			for(unsigned t=0; t<touched.size(); t++) {
+				unsigned q = touched[t];
+				if(q == own)
+					continue;
+				//only the weights the vertex adds to need to stay under the limits. A
+				//vertex leaving a part over on memory may take a part that is full on
+				//ops over by itself (and the other way around), that part then sheds
+				//ops in the next balancing pass
+				bool opsRoom = pwOps[q] + g.ops[v] <= limOps || (balancing && g.mem[v] && pwMem[own] > limMem && pwOps[q] <= limOps);
+				bool memRoom = pwMem[q] + g.mem[v] <= limMem || (balancing && g.ops[v] && pwOps[own] > limOps && pwMem[q] <= limMem);
+				if((g.ops[v] && !opsRoom) || (g.mem[v] && !memRoom))
+					continue;
+				long long gain = conn[q] - conn[own];
+				bool receiver = donor && ((!g.mem[v] && pwMem[q] > limMem) || (!g.ops[v] && pwOps[q] > limOps));
+				bool useful = gain > 0 || ownOver || receiver || (gain == 0 && pwOps[q] + g.ops[v] < pwOps[own]);
+				if(!useful)
+					continue;
+				double load = (double)pwOps[q]/limOps + (limMem ? (double)pwMem[q]/limMem : 0);
+				if(best == own || gain > bestGain || (gain == bestGain && load < bestLoad)) {
+					bestLoad = load;
+					best = q;
+					bestGain = gain;
+				}
+			}
+
+			for(unsigned t=0; t<touched.size(); t++)
+				conn[touched[t]] = 0;
+			conn[own] = 0;
+
+			if(best != own) {
+				part[v] = best;
+				pwOps[own] -= g.ops[v];
+				pwMem[own] -= g.mem[v];
+				pwOps[best] += g.ops[v];
+				pwMem[best] += g.mem[v];
+				moves++;
+			}
+		}
+
+		if(moves == 0) {
+			if(balancing)
+				break;
+			pass = passes-1;
+		}
+	}
+}
+
+Partitioner::Partitioner(unsigned k) {
+	parts = k;
+	imbalance = 0.03;
+	coarsenTo = 0;
+	refinePasses = 8;
+	cut = 0;
+	volume = 0;
+}
+
+/*
+ * Partitions the graph and returns the number of cut edges
+ */
+long long unsigned Partitioner::partition(CSRGraph &graph) {
+	ull n = graph.nodes;
+	unsigned k = max(parts,1u);
+
+	//finest level: every edge in both directions, node weights from the graph
+	vector<PartLevel> levels(1);
+	PartLevel &base = levels[0];
+	base.n = n;
+	base.xadj.assign(n+1,0);
+	base.adj.resize(2*graph.edges);
+	base.adjw.assign(2*graph.edges,1);
+	base.ops.assign(n,1);
+	base.mem.resize(n);
+	for(ull i=0; i<n; i++) {
+		base.mem[i] = graph.memType(i);
+		base.xadj[i+1] = base.xadj[i] + graph.inDegree(i) + graph.outDegree(i);
+		ull pos = base.xadj[i];
+		for(ull e=graph.predOffset[i]; e<graph.predOffset[i+1]; e++)
+			base.adj[pos++] = graph.pred[e];
+		for(ull e=graph.succOffset[i]; e<graph.succOffset[i+1]; e++)
+			base.adj[pos++] = graph.succ[e];
+	}
+
+	ull totalMem = 0;
+	for(ull i=0; i<n; i++)
+		totalMem += base.mem[i];
+
+	//coarsen until small enough or matching stops shrinking the graph
+	ull target = coarsenTo ? coarsenTo : max((ull)20*k,(ull)256);
+	ull capOps = max((ull)2,(ull)(1.5*n/target));
+	ull capMem = max((ull)2,(ull)(1.5*totalMem/target));
+	while(levels.back().n > target) {
+		ull cn = matchLevel(levels.back(),capOps,capMem);
+		if(cn > 0.95*levels.back().n) {
+			levels.back().cmap.clear();
+			break;
+		}
+		levels.push_back(PartLevel());
+		contractLevel(levels[levels.size()-2],levels.back(),cn);
+	}
+
+	//split the coarsest level then project and refine back to the original graph
+	vector<unsigned> levelPart;
+	initialPartition(levels.back(),k,levelPart);
+	refineLevel(levels.back(),k,imbalance,refinePasses,levelPart);
+	for(ull l=levels.size()-1; l-- > 0; ) {
+		PartLevel &fine = levels[l];
+		vector<unsigned> finePart(fine.n);
+		for(ull v=0; v<fine.n; v++)
+			finePart[v] = levelPart[fine.cmap[v]];
+		levelPart.swap(finePart);
+		levels.pop_back();
+		refineLevel(fine,k,imbalance,refinePasses,levelPart);
+	}
+	part.swap(levelPart);
+	levels.clear();
+
+	//cut statistics on the directed graph
+	partOps.assign(k,0);
+	partMem.assign(k,0);
+	partCut.assign(k,0);
+	cut = 0;
+	volume = 0;
+	vector<ull> seen(k,(ull)-1);
+	for(ull i=0; i<n; i++) {
+		unsigned p = part[i];
+		partOps[p]++;
+		partMem[p] += graph.memType(i);
+		for(ull e=graph.succOffset[i]; e<graph.succOffset[i+1]; e++) {
+			unsigned q = part[graph.succ[e]];
+			if(q == p)
+				continue;
+			cut++;
+			partCut[p]++;
+			if(seen[q] != i) {
+				seen[q] = i;
+				volume++;
+			}
+		}
+	}
+
+	return cut;
+}
+
+/*
+ * Writes the part of each node, one per line
+ */
+void Partitioner::writePartition(string filename) {
+	FILE *fp = fopen(filename.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	for(ull i=0; i<part.size(); i++)
+		fprintf(fp,"%u\n",part[i]);
+
+	fclose(fp);
+}
+
+/*
+ * Writes the totals followed by one line per part: part ops mem cut
+ */
+void Partitioner::writeCutStats(string filename) {
+	FILE *fp = fopen(filename.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	fprintf(fp,"parts %u\n",(unsigned)partOps.size());
+	fprintf(fp,"cut %llu\n",cut);
+	fprintf(fp,"volume %llu\n",volume);
+	for(unsigned p=0; p<partOps.size(); p++)
+		fprintf(fp,"%u %llu %llu %llu\n",p,partOps[p],partMem[p],partCut[p]);
+
+	fclose(fp);
+}
@@ -0,0 +1,71 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Partitioner.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+
+#include "CSRGraph.h"
+
+#ifndef _PARTITIONER_
+#define _PARTITIONER_
+
+using namespace std;
+
+/*
+ * Multilevel k-way partitioner for a traced graph. Minimizes the number of
+ * edges between parts while keeping both the op count and the memory
+ * accesses (from the node memory type) of every part within imbalance of
+ * the average. The graph is coarsened by heavy edge matching, the coarsest
+ * graph is split by greedy growing, and each level is refined on the way
+ * back with boundary moves. Every phase is linear in the graph size.
+ */
+class Partitioner {
+public:
+	unsigned parts;
+	//allowed fraction over the average weight of a part, for ops and for memory accesses
+	double imbalance;
+	//stop coarsening at this many vertices (0 picks one from the part count)
+	long long unsigned coarsenTo;
+	//maximum refinement passes per level
+	unsigned refinePasses;
+
+	//part of each node
+	vector<unsigned> part;
+	//ops and memory accesses in each part
+	vector<long long unsigned> partOps;
+	vector<long long unsigned> partMem;
+	//edges between parts, and values sent to another part (a value going to
+	//several nodes in the same part is counted once)
+	long long unsigned cut;
+	long long unsigned volume;
+	//edges leaving each part
+	vector<long long unsigned> partCut;
+
+	Partitioner(unsigned parts);
+
+	long long unsigned partition(CSRGraph &graph);
+
+	void writePartition(string filename);
+	void writeCutStats(string filename);
+};
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ReductionTrees.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <algorithm>
+
+#include <stdio.h>
+
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "ReductionTrees.h"
+
+using namespace std;
+
+typedef long long unsigned ull;
+
+ReductionTrees::ReductionTrees() {
+	trees = 0;
+	collapsed = 0;
+}
+
+static bool isSum(CSRGraph &graph, ull i) {
+	int op = graph.opType(i);
+	return op == Types::Add || op == Types::Sub;
+}
+
+/*
+ * Builds the reduced graph where every tree of two or more Add/Sub nodes
+ * is replaced by one Reduce node at the position of its root, with the
+ * memory accesses of the whole tree and an edge from every node feeding
+ * it. A tree with more than the 4 accesses its type can hold gets its exact
+ * count through CSRGraph::setMemory, so the reduced graph has the same
+ * memory traffic. Nodes listed in outputs are never absorbed into a
+ * consumer. Returns the number of nodes removed.
+ */
+long long unsigned ReductionTrees::collapse(CSRGraph &graph, CSRGraph &reduced, vector<long long unsigned> *outputs) {
+	ull n = graph.nodes;
+
+	vector<char> keep(n,0);
+	if(outputs != NULL)
+		for(ull k=0; k<outputs->size(); k++)
+			if(outputs->at(k) < n)
+				keep[outputs->at(k)] = 1;
+
+	//nodes that are part of their successor's tree
+	vector<char> merged(n,0);
+	for(ull i=0; i<n; i++)
+		merged[i] = !keep[i] && graph.outDegree(i) == 1 && isSum(graph,i) && isSum(graph,graph.succ[graph.succOffset[i]]);
+
+	//the root of each tree, successors always have higher ids
+	vector<unsigned> root(n,0);
+	for(ull i=n; i-- > 0; )
+		root[i] = merged[i] ? root[graph.succ[graph.succOffset[i]]] : i;
+
+	//ops and longest chain of ops in each subtree, memory accesses per tree
+	vector<ull> ops(n,0);
+	vector<ull> height(n,0);
+	vector<ull> mem(n,0);
+	for(ull i=0; i<n; i++) {
+		if(!isSum(graph,i))
+			continue;
+		ops[i]++;
+		height[i]++;
+		for(ull e=graph.predOffset[i]; e<graph.predOffset[i+1]; e++) {
+			unsigned p = graph.pred[e];
+			if(!merged[p])
+				continue;
+			ops[i] += ops[p];
+			if(height[i] < height[p]+1)
+				height[i] = height[p]+1;
+		}
+		mem[root[i]] += graph.memType(i);
+	}
+
+	original.clear();
+	arity.clear();
+	depth.clear();
+	memory.clear();
+	trees = 0;
+	vector<unsigned> newId(n,0);
+	vector<int> types;
+	//memory accesses of every node of the reduced graph
+	vector<ull> exact;
+	bool capped = !graph.memory.empty();
+	for(ull i=0; i<n; i++) {
+		if(merged[i])
+			continue;
+		newId[i] = original.size();
+		original.push_back(i);
+		if(isSum(graph,i) && ops[i] > 1) {
+			//the type holds at most 4 memory accesses
+			types.push_back(Types::setMemType(mem[i] > 4 ? 4 : mem[i]) + Types::Reduce);
+			arity.push_back(ops[i]+1);
+			depth.push_back(height[i]);
+			memory.push_back(mem[i]);
+			exact.push_back(mem[i]);
+			capped = capped || mem[i] > 4;
+			trees++;
+		}
+		else {
+			types.push_back(graph.type[i]);
+			arity.push_back(0);
+			depth.push_back(0);
+			memory.push_back(0);
+			exact.push_back(graph.memType(i));
+		}
+	}
+
+	//edges into a tree go to its root, an operand feeding a tree twice is one edge
+	vector<pair<unsigned,unsigned> > edgeList;
+	for(ull k=0; k<original.size(); k++) {
+		unsigned i = original[k];
+		ull first = edgeList.size();
+		for(ull e=graph.succOffset[i]; e<graph.succOffset[i+1]; e++)
+			edgeList.push_back(pair<unsigned,unsigned>(k,newId[root[graph.succ[e]]]));
+		sort(edgeList.begin()+first,edgeList.end());
+		edgeList.erase(unique(edgeList.begin()+first,edgeList.end()),edgeList.end());
+	}
+
+	reduced.build(original.size(),types,edgeList);
+	if(capped)
+		for(ull k=0; k<exact.size(); k++)
+			reduced.setMemory(k,exact[k]);
+
+	collapsed = n - original.size();
+	return collapsed;
+}
+
+/*
+ * Writes one line per Reduce node: node arity depth memory (reduced graph
+ * ids, memory is the exact number of accesses of the tree)
+ */
+void ReductionTrees::writeReductions(string filename) {
+	FILE *fp = fopen(filename.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	for(ull i=0; i<arity.size(); i++)
+		if(arity[i] != 0)
+			fprintf(fp,"%llu %llu %llu %llu\n",i,arity[i],depth[i],memory[i]);
+
+	fclose(fp);
+}
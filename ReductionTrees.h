@@ -0,0 +1,62 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ReductionTrees.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+
+#include "CSRGraph.h"
+
+#ifndef _REDUCTIONTREES_
+#define _REDUCTIONTREES_
+
+using namespace std;
+
+/*
+ * Collapses trees of Add/Sub nodes (the balanced trees built by
+ * LinearAlgebra::reduction and reductionNeg as well as linear chains of
+ * accumulations) into single n-ary Reduce nodes, the way an adder tree
+ * would implement them. A node belongs to its consumer's tree when it is
+ * an Add or Sub whose only successor is also an Add or Sub. Trees of one
+ * binary op are left as they are.
+ */
+class ReductionTrees {
+public:
+	//per node of the reduced graph, 0 for nodes that are not Reduce nodes:
+	//number of operands summed, number of binary ops on the longest path
+	//and memory accesses of the whole tree
+	vector<long long unsigned> arity;
+	vector<long long unsigned> depth;
+	vector<long long unsigned> memory;
+	//original id of each node of the reduced graph
+	vector<unsigned> original;
+
+	long long unsigned trees;
+	//nodes removed by the last collapse
+	long long unsigned collapsed;
+
+	ReductionTrees();
+
+	long long unsigned collapse(CSRGraph &graph, CSRGraph &reduced, vector<long long unsigned> *outputs = NULL);
+	void writeReductions(string filename);
+};
+
+#endif
@@ -0,0 +1,224 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ReuseDistance.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <stdio.h>
+
+#include "ReuseDistance.h"
+
+using namespace std;
+
+ReuseDistance::ReuseDistance(long long unsigned lineSize, MemoryModel *inner) {
+	this->lineSize = (lineSize > 0) ? lineSize : 1;
+	this->inner = inner;
+	coldMisses = 0;
+	accesses = 0;
+	recordLevels = false;
+	now = 0;
+	tree.assign(1024+1,0);
+}
+
+bool ReuseDistance::access(long long unsigned addr) {
+	long long unsigned line = addr / lineSize;
+	bool hit;
+
+	//make room for the new time slot
+	if(now+1 >= tree.size())
+		compact();
+
+	accesses++;
+
+	unordered_map<long long unsigned, long long unsigned>::iterator it = last.find(line);
+	long long unsigned level = levelLines.size();
+	if(it == last.end()) {
+		coldMisses++;
+		hit = false;
+		last[line] = now;
+	}
+	else {
+		//distinct lines touched since the last access to this line
+		long long unsigned distance = prefix(now) - prefix(it->second+1);
+
+		if(histogram.size() <= distance)
+			histogram.resize(distance+1,0);
+		histogram[distance]++;
+
+		for(unsigned l=0; l<levelLines.size(); l++) {
+			if(distance < levelLines[l]) {
+				level = l;
+				break;
+			}
+		}
+
+		add(it->second,-1);
+		it->second = now;
+		hit = true;
+	}
+	add(now,1);
+	now++;
+
+	if(levelAccesses.size() > 0)
+		levelAccesses[level]++;
+	if(recordLevels)
+		accessLevels.push_back(level);
+
+	if(inner != NULL)
+		hit = inner->access(addr);
+
+	if(hit)
+		hits++;
+	else
+		misses++;
+
+	return hit;
+}
+
+void ReuseDistance::reset() {
+	MemoryModel::reset();
+	if(inner != NULL)
+		inner->reset();
+
+	histogram.clear();
+	coldMisses = 0;
+	accesses = 0;
+	levelAccesses.assign(levelAccesses.size(),0);
+	accessLevels.clear();
+	last.clear();
+	now = 0;
+	tree.assign(1024+1,0);
+}
+
+/*
+ * Sets the capacities (in bytes, smallest first) of the memory levels that
+ * each access is assigned to as it is traced. An access goes to the first
+ * level that holds its reuse distance, or off-chip (the last entry of
+ * levelAccesses) if none do or the line is touched for the first time.
+ */
+void ReuseDistance::setLevels(vector<long long unsigned> &capacities) {
+	levelLines.clear();
+	for(unsigned l=0; l<capacities.size(); l++)
+		levelLines.push_back(capacities[l] / lineSize);
+	levelAccesses.assign(capacities.size()+1,0);
+}
+
+/*
+ * Returns the number of accesses that would be served by each level of a
+ * hierarchy with the given capacities (in bytes, smallest first), computed
+ * from the histogram. The last entry is the number of off-chip accesses.
+ */
+vector<long long unsigned> ReuseDistance::levelCounts(vector<long long unsigned> &capacities) {
+	vector<long long unsigned> counts(capacities.size()+1,0);
+
+	long long unsigned d = 0;
+	for(unsigned l=0; l<capacities.size(); l++) {
+		long long unsigned lines = capacities[l] / lineSize;
+		for(; d<lines && d<histogram.size(); d++)
+			counts[l] += histogram[d];
+	}
+	for(; d<histogram.size(); d++)
+		counts[capacities.size()] += histogram[d];
+	counts[capacities.size()] += coldMisses;
+
+	return counts;
+}
+
+/*
+ * Writes one "distance count" line per reuse distance that occurred,
+ * followed by the number of cold misses
+ */
+void ReuseDistance::writeHistogram(string filename) {
+	ofstream myfile;
+	myfile.open (filename.c_str());
+
+	for(long long unsigned i=0; i<histogram.size(); i++) {
+		if(histogram[i] > 0)
+			myfile << i << " " << histogram[i] << "\n";
+	}
+	myfile << "cold " << coldMisses << "\n";
+	myfile.close();
+}
+
+/*
+ * Writes the accesses served by each level of the given hierarchy, one
+ * "capacity count" line per level followed by the off-chip accesses
+ */
+void ReuseDistance::writeLevels(string filename, vector<long long unsigned> &capacities) {
+	vector<long long unsigned> counts = levelCounts(capacities);
+
+	ofstream myfile;
+	myfile.open (filename.c_str());
+
+	for(unsigned l=0; l<capacities.size(); l++)
+		myfile << capacities[l] << " " << counts[l] << "\n";
+	myfile << "offchip " << counts[capacities.size()] << "\n";
+	myfile.close();
+}
+
+void ReuseDistance::add(long long unsigned pos, int val) {
+	for(long long unsigned i=pos+1; i<tree.size(); i+=i&(-i))
+		tree[i] += val;
+}
+
+/*
+ * Returns the number of marked time slots before pos
+ */
+long long unsigned ReuseDistance::prefix(long long unsigned pos) {
+	long long unsigned sum = 0;
+	for(long long unsigned i=pos; i>0; i-=i&(-i))
+		sum += tree[i];
+	return sum;
+}
+
+/*
+ * Renumbers the live time slots (one per distinct line) to 0..k-1 keeping
+ * their order, and resizes the tree so there is room for at least k more
+ * accesses before the next compaction
+ */
+void ReuseDistance::compact() {
+	vector<pair<long long unsigned,long long unsigned> > order;
+	order.reserve(last.size());
+
+	unordered_map<long long unsigned, long long unsigned>::iterator it;
+	for(it=last.begin(); it != last.end(); it++)
+		order.push_back(pair<long long unsigned,long long unsigned>(it->second,it->first));
+	sort(order.begin(),order.end());
+
+	for(long long unsigned i=0; i<order.size(); i++)
+		last[order[i].second] = i;
+	now = order.size();
+
+	//build the tree with the first k slots marked in O(size)
+	long long unsigned size = max(2*now,(long long unsigned)1024)+1;
+	tree.assign(size,0);
+	for(long long unsigned i=1; i<size; i++) {
+		if(i <= now)
+			tree[i]++;
+		long long unsigned parent = i + (i&(-i));
+		if(parent < size)
+			tree[parent] += tree[i];
+	}
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ReuseDistance.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "MemoryModel.h"
+
+#ifndef _REUSEDISTANCE_
+#define _REUSEDISTANCE_
+
+using namespace std;
+
+/*
+ * Computes the reuse (stack) distance of every traced operand access: the
+ * number of distinct lines touched since the previous access to the same
+ * line. Uses Olken's algorithm with a Fenwick tree over access times, so
+ * each access costs O(log n), and the times are periodically compacted so
+ * memory stays proportional to the number of distinct lines.
+ *
+ * Install it as the memoryModel to record the trace. Hits and misses are
+ * decided by the inner model if one is given, otherwise by first touch.
+ * From the histogram the accesses reaching each level of a memory
+ * hierarchy can then be computed for any set of capacities without
+ * retracing: an access hits in a fully associative LRU memory of C lines
+ * exactly when its distance is less than C.
+ */
+class ReuseDistance : public MemoryModel {
+public:
+	//histogram[d] = number of accesses with reuse distance d (in lines)
+	vector<long long unsigned> histogram;
+	//accesses to lines never touched before (infinite distance)
+	long long unsigned coldMisses;
+	long long unsigned accesses;
+
+	//accesses assigned to each level by setLevels, the last entry is off-chip
+	vector<long long unsigned> levelAccesses;
+	//level of every access when recordLevels is set
+	vector<unsigned char> accessLevels;
+	bool recordLevels;
+
+	ReuseDistance(long long unsigned lineSize = 1, MemoryModel *inner = NULL);
+
+	bool access(long long unsigned addr);
+	void reset();
+
+	void setLevels(vector<long long unsigned> &capacities);
+	vector<long long unsigned> levelCounts(vector<long long unsigned> &capacities);
+
+	void writeHistogram(string filename);
+	void writeLevels(string filename, vector<long long unsigned> &capacities);
+
+private:
+	long long unsigned lineSize;
+	MemoryModel *inner;
+
+	//capacity of each level in lines for online assignment
+	vector<long long unsigned> levelLines;
+
+	//time slot of the last access to each line
+	unordered_map<long long unsigned, long long unsigned> last;
+	//Fenwick tree marking the time slots that are the latest access to a line
+	vector<unsigned> tree;
+	long long unsigned now;
+
+	void add(long long unsigned pos, int val);
+	long long unsigned prefix(long long unsigned pos);
+	void compact();
+};
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SourceLocations.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+
+#include <stdio.h>
+
+#include "CSRGraph.h"
+#include "SourceLocations.h"
+
+using namespace std;
+
+typedef long long unsigned ull;
+
+vector<pair<string,unsigned> > SourceLocations::table(1,make_pair(string("unknown"),0u));
+map<pair<string,unsigned>,unsigned> SourceLocations::ids;
+
+SourceLocations::SourceLocations() {
+	depth = 0;
+}
+
+/*
+ * Returns the id of the given file and line, adding it to the table the
+ * first time it is seen
+ */
+unsigned SourceLocations::intern(const char *file, unsigned line) {
+	pair<string,unsigned> key(file,line);
+
+	map<pair<string,unsigned>,unsigned>::iterator it = ids.find(key);
+	if(it != ids.end())
+		return it->second;
+
+	unsigned id = table.size();
+	ids[key] = id;
+	table.push_back(key);
+	return id;
+}
+
+string SourceLocations::name(unsigned id) {
+	if(id == 0 || id >= table.size())
+		return "unknown";
+
+	char line[16];
+	snprintf(line,sizeof(line),":%u",table[id].second);
+	return table[id].first + line;
+}
+
+/*
+ * Counts the ops of each location, the ops with zero slack and the ops on
+ * one critical path (walked back from the deepest node). locations holds
+ * the location id of each node, nodes past its end are unknown.
+ */
+void SourceLocations::analyze(CSRGraph &graph, vector<unsigned> &locations) {
+	ull n = graph.nodes;
+
+	ops.assign(table.size(),0);
+	critical.assign(table.size(),0);
+	path.assign(table.size(),0);
+	depth = 0;
+
+	if(n == 0)
+		return;
+
+	vector<ull> level = graph.levels();
+	vector<ull> alap = graph.alapLevels(level);
+	vector<ull> mobility = graph.slack(level,alap);
+
+	ull deepest = 0;
+	for(ull i=0; i<n; i++) {
+		if(graph.type[i] == 0)
+			continue;
+
+		unsigned loc = (i < locations.size() && locations[i] < table.size()) ? locations[i] : 0;
+		ops[loc]++;
+		if(mobility[i] == 0)
+			critical[loc]++;
+
+		if(level[i]+1 > depth) {
+			depth = level[i]+1;
+			deepest = i;
+		}
+	}
+
+	//walk back along predecessors one level shallower
+	ull i = deepest;
+	while(true) {
+		unsigned loc = (i < locations.size() && locations[i] < table.size()) ? locations[i] : 0;
+		path[loc]++;
+
+		if(level[i] == 0)
+			break;
+
+		for(ull e=graph.predOffset[i]; e<graph.predOffset[i+1]; e++) {
+			if(level[graph.pred[e]]+1 == level[i]) {
+				i = graph.pred[e];
+				break;
+			}
+		}
+	}
+}
+
+/*
+ * Writes "depth N" then one "file:line ops critical path" line per
+ * location that has ops, longest share of the critical path first
+ */
+void SourceLocations::print(FILE *fp) {
+	vector<pair<pair<ull,ull>,unsigned> > order;
+	for(unsigned id=0; id<ops.size(); id++)
+		if(ops[id] > 0)
+			order.push_back(make_pair(make_pair(path[id],critical[id]),id));
+	sort(order.rbegin(),order.rend());
+
+	fprintf(fp,"depth %llu\n",depth);
+	for(unsigned k=0; k<order.size(); k++) {
+		unsigned id = order[k].second;
+		fprintf(fp,"%s %llu %llu %llu\n",name(id).c_str(),ops[id],critical[id],path[id]);
+	}
+}
+
+void SourceLocations::printReport() {
+	print(stdout);
+}
+
+void SourceLocations::writeReport(string filename) {
+	FILE *fp = fopen(filename.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	print(fp);
+	fclose(fp);
+}
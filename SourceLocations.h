@@ -0,0 +1,70 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * SourceLocations.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+#include <map>
+
+#include <stdio.h>
+
+#include "CSRGraph.h"
+
+#ifndef _SOURCELOCATIONS_
+#define _SOURCELOCATIONS_
+
+using namespace std;
+
+/*
+ * Table of the source lines traced ops came from, each interned once so a
+ * node only needs the 4 byte id of its line (see Data::setProvenance).
+ * Id 0 is an unknown location. analyze() attributes the ops and critical
+ * path of a traced graph to the lines that created them.
+ */
+class SourceLocations {
+public:
+	//file and line of each location id
+	static vector<pair<string,unsigned> > table;
+
+	static unsigned intern(const char *file, unsigned line);
+	static string name(unsigned id);
+
+	//per location id: ops, ops with no slack (on some critical path) and
+	//ops on the one critical path found
+	vector<long long unsigned> ops;
+	vector<long long unsigned> critical;
+	vector<long long unsigned> path;
+
+	long long unsigned depth;
+
+	SourceLocations();
+
+	void analyze(CSRGraph &graph, vector<unsigned> &locations);
+	void printReport();
+	void writeReport(string filename);
+
+private:
+	static map<pair<string,unsigned>,unsigned> ids;
+
+	void print(FILE *fp);
+};
+
+#endif
@@ -84,6 +84,11 @@ void SparseMatrix::setNew(long i, long j, int val) {
 }
 
 
+void SparseMatrix::remove(long i, long j) {
+	SparseSet s(i,j,0);
+	data_row.erase(s);
+}
+
 int SparseMatrix::get(long i, long j) {
 	SparseSet s(i,j,0);
 	set<SparseSet,SparseSetCompareRow, allocator<SparseSet> >::iterator oth = data_row.find(s);
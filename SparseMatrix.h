@@ -81,6 +81,7 @@ public:
 	~SparseMatrix();
 	void setNew(long i, long j, int val);
 	void setData(long i, long j, int val);
+	void remove(long i, long j);
 	int get(long i, long j);
 	void displayFull();
 	string toString();
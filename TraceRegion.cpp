@@ -0,0 +1,42 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * TraceRegion.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "TraceRegion.h"
+
+bool recording = true;
+
+TraceRegion::TraceRegion(bool record) {
+	previous = recording;
+	recording = record;
+}
+
+TraceRegion::~TraceRegion() {
+	recording = previous;
+}
+
+void TraceRegion::setRecording(bool enable) {
+	recording = enable;
+}
+
+bool TraceRegion::isRecording() {
+	return recording;
+}
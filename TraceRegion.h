@@ -0,0 +1,55 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * TraceRegion.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef _TRACEREGION_
+#define _TRACEREGION_
+
+//ops are only traced while this is set, see TraceRegion
+extern bool recording;
+
+/*
+ * Turns tracing on (or off) for the lifetime of the guard and restores the
+ * previous setting afterwards, so a kernel inside a larger program can be
+ * traced on its own:
+ *
+ *   TraceRegion::setRecording(false);
+ *   ...
+ *   { TraceRegion r; kernel(); }
+ *
+ * While recording is off the operators only compute values: no nodes,
+ * memory accesses or stages are recorded and the results are fresh
+ * variables, so using them in a traced region costs a memory read like any
+ * other input. Tracing is not thread safe so the flag is global.
+ */
+class TraceRegion {
+public:
+	TraceRegion(bool record = true);
+	~TraceRegion();
+
+	static void setRecording(bool enable);
+	static bool isRecording();
+
+private:
+	bool previous;
+};
+
+#endif
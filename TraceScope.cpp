@@ -0,0 +1,220 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * TraceScope.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+
+#include <stdio.h>
+
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "TraceScope.h"
+
+using namespace std;
+
+typedef long long unsigned ull;
+
+vector<TraceScope::Region> TraceScope::regions;
+vector<TraceScope::Instance> TraceScope::stack;
+
+/*
+ * Enters the region with the given name under the innermost active scope,
+ * creating it the first time it is entered there
+ */
+TraceScope::TraceScope(string name) {
+	int parent = stack.empty() ? -1 : (int)stack.back().region;
+
+	//top level regions have no parent to hold their list, search them all
+	unsigned region = regions.size();
+	if(parent < 0) {
+		for(unsigned r=0; r<regions.size(); r++)
+			if(regions[r].parent < 0 && regions[r].name == name)
+				region = r;
+	}
+	else {
+		vector<unsigned> &children = regions[parent].children;
+		for(unsigned c=0; c<children.size(); c++)
+			if(regions[children[c]].name == name)
+				region = children[c];
+	}
+
+	if(region == regions.size()) {
+		Region r;
+		r.name = name;
+		r.parent = parent;
+		r.instances = 0;
+		r.work = 0;
+		r.memAccesses = 0;
+		r.span = 0;
+		r.width = 0;
+		regions.push_back(r);
+
+		if(parent >= 0)
+			regions[parent].children.push_back(region);
+	}
+
+	regions[region].instances++;
+	regions[region].ranges.push_back(make_pair(opCount,opCount));
+
+	Instance instance;
+	instance.region = region;
+	instance.start = opCount;
+	stack.push_back(instance);
+}
+
+TraceScope::~TraceScope() {
+	regions[stack.back().region].ranges.back().second = opCount;
+	finish(stack.back());
+	stack.pop_back();
+}
+
+/*
+ * Adds the next op of the instance and returns its depth within it: one
+ * more than the deepest of its predecessors traced in the same instance
+ */
+ull TraceScope::addOp(Instance &instance, ull *preds, unsigned numPreds) {
+	ull d = 1;
+	for(unsigned k=0; k<numPreds; k++) {
+		if(preds[k] < instance.start || preds[k] - instance.start >= instance.depth.size())
+			continue;
+		ull pd = instance.depth[preds[k] - instance.start] + 1;
+		if(pd > d)
+			d = pd;
+	}
+
+	instance.depth.push_back(d);
+	if(instance.width.size() < d)
+		instance.width.resize(d,0);
+	instance.width[d-1]++;
+	return d;
+}
+
+/*
+ * Adds the span and width of a finished instance to its region
+ */
+void TraceScope::finish(Instance &instance) {
+	Region &region = regions[instance.region];
+	region.span += instance.width.size();
+	for(ull d=0; d<instance.width.size(); d++)
+		if(instance.width[d] > region.width)
+			region.width = instance.width[d];
+}
+
+/*
+ * Attributes the op being traced (the next op id) to every active scope,
+ * called by Data with the op's memory accesses and the ids of the ops that
+ * produced its operands
+ */
+void TraceScope::addOp(int mem, ull *preds, unsigned numPreds) {
+	for(unsigned s=0; s<stack.size(); s++) {
+		addOp(stack[s],preds,numPreds);
+		regions[stack[s].region].work++;
+		regions[stack[s].region].memAccesses += mem;
+	}
+}
+
+/*
+ * Rebuilds the statistics of every region from the traced graph using the
+ * op ids recorded for each instance. Ids outside the graph and empty
+ * (pruned) nodes are skipped.
+ */
+void TraceScope::profile(CSRGraph &graph) {
+	vector<ull> preds;
+
+	for(unsigned r=0; r<regions.size(); r++) {
+		Region &region = regions[r];
+		region.work = 0;
+		region.memAccesses = 0;
+		region.span = 0;
+		region.width = 0;
+
+		for(unsigned k=0; k<region.ranges.size(); k++) {
+			Instance instance;
+			instance.region = r;
+			instance.start = region.ranges[k].first;
+
+			ull last = region.ranges[k].second;
+			if(last > graph.nodes)
+				last = graph.nodes;
+
+			for(ull i=instance.start; i<last; i++) {
+				if(graph.type[i] == 0) {
+					//keeps the depths lined up with the ids
+					instance.depth.push_back(0);
+					continue;
+				}
+
+				preds.assign(graph.pred.begin()+graph.predOffset[i],graph.pred.begin()+graph.predOffset[i+1]);
+				addOp(instance,preds.data(),preds.size());
+				region.work++;
+				region.memAccesses += graph.memType(i);
+			}
+
+			finish(instance);
+		}
+	}
+}
+
+/*
+ * Removes all regions, scopes that are still active must not be closed
+ * afterwards
+ */
+void TraceScope::clear() {
+	regions.clear();
+	stack.clear();
+}
+
+void TraceScope::print(FILE *fp, unsigned r, string path) {
+	Region &region = regions[r];
+	path += region.name;
+
+	double parallelism = (region.span > 0) ? (double)region.work / region.span : 0;
+	fprintf(fp,"%s %llu %llu %llu %.2f %llu %llu\n",path.c_str(),region.instances,region.work,region.span,parallelism,region.memAccesses,region.width);
+
+	for(unsigned c=0; c<region.children.size(); c++)
+		print(fp,region.children[c],path + "/");
+}
+
+/*
+ * Writes one "path instances work span parallelism memAccesses width" line
+ * per region, parents before their children and nested names joined by '/'
+ */
+void TraceScope::print(FILE *fp) {
+	for(unsigned r=0; r<regions.size(); r++)
+		if(regions[r].parent < 0)
+			print(fp,r,"");
+}
+
+void TraceScope::printProfile() {
+	print(stdout);
+}
+
+void TraceScope::writeProfile(string filename) {
+	FILE *fp = fopen(filename.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",filename.c_str());
+		return;
+	}
+
+	print(fp);
+	fclose(fp);
+}
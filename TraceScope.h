@@ -0,0 +1,103 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * TraceScope.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+
+#include <stdio.h>
+
+#include "CSRGraph.h"
+
+#ifndef _TRACESCOPE_
+#define _TRACESCOPE_
+
+using namespace std;
+
+/*
+ * Marks a named region of the traced program for the duration of its
+ * lifetime, for example TraceScope s("cholesky_panel") at the top of a
+ * loop body. Scopes nest: a scope entered while another is active becomes
+ * its child, and every op counts toward the innermost scope and all of its
+ * ancestors. Entering the same name again under the same parent adds to
+ * the same region, so each region aggregates all of its instances.
+ *
+ * The span of an instance is its longest path counting only dependences on
+ * ops of the same instance, so values computed before the instance began
+ * are treated as inputs. For every region the profile reports the work
+ * (ops), the span summed over its instances (the critical path when the
+ * instances run one after another), the parallelism (work/span), the
+ * memory accesses and the peak width (most ops at one depth of any
+ * instance). With the stage version of Data the profile is built while
+ * tracing, keeping the depth of every op of each active instance. With the
+ * full version call profile() on the traced graph once tracing is done.
+ */
+class TraceScope {
+public:
+	struct Region {
+		string name;
+		int parent;
+		vector<unsigned> children;
+
+		//number of times the region was entered
+		long long unsigned instances;
+		long long unsigned work;
+		long long unsigned memAccesses;
+		//sum of the spans of the instances and most ops at one depth of any instance
+		long long unsigned span;
+		long long unsigned width;
+
+		//op ids [first, second) traced in each instance
+		vector<pair<long long unsigned,long long unsigned> > ranges;
+	};
+
+	static vector<Region> regions;
+
+	TraceScope(string name);
+	~TraceScope();
+
+	static bool active() { return !stack.empty(); }
+	static void addOp(int mem, long long unsigned *preds, unsigned numPreds);
+	static void profile(CSRGraph &graph);
+	static void clear();
+
+	static void printProfile();
+	static void writeProfile(string filename);
+
+private:
+	//an active instance: first op id and the depth of each of its ops
+	//within it, and the ops at each depth
+	struct Instance {
+		unsigned region;
+		long long unsigned start;
+		vector<long long unsigned> depth;
+		vector<long long unsigned> width;
+	};
+
+	static vector<Instance> stack;
+
+	static long long unsigned addOp(Instance &instance, long long unsigned *preds, unsigned numPreds);
+	static void finish(Instance &instance);
+	static void print(FILE *fp);
+	static void print(FILE *fp, unsigned r, string path);
+};
+
+#endif
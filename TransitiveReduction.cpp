@@ -0,0 +1,175 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * TransitiveReduction.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "CSRGraph.h"
+#include "TransitiveReduction.h"
+
+using namespace std;
+
+typedef long long unsigned ull;
+
+/*
+ * Marks the redundant edges into the block of target ids [lo,hi). For each
+ * node u (in reverse order) reach[u] is the set of block ids reachable from
+ * u through at least one edge. An edge u->v is redundant exactly when v is
+ * reachable from another successor of u, ie. v is in the union of the
+ * successors' reach sets. Nodes at or after hi cannot reach the block.
+ */
+static void reduceBlock(CSRGraph &graph, ull lo, ull hi, vector<uint64_t> &bits, vector<char> &nonEmpty, vector<char> &redundant) {
+	ull words = (hi - lo + 63) / 64;
+	bits.resize(hi*words);
+	nonEmpty.assign(hi,0);
+
+	for(ull u=hi; u-- > 0; ) {
+		uint64_t *acc = &bits[u*words];
+		bool any = false;
+		ull end = graph.succOffset[u+1];
+		ull e;
+		for(e=graph.succOffset[u]; e<end && graph.succ[e]<hi; e++) {
+			unsigned w = graph.succ[e];
+			if(!nonEmpty[w])
+				continue;
+			uint64_t *from = &bits[(ull)w*words];
+			if(!any)
+				memcpy(acc,from,words*sizeof(uint64_t));
+			else
+				for(ull k=0; k<words; k++)
+					acc[k] |= from[k];
+			any = true;
+		}
+		if(!any)
+			memset(acc,0,words*sizeof(uint64_t));
+		end = e;
+
+		//successors inside the block: check then add them to the reach set
+		for(e=graph.succOffset[u]; e<end; e++) {
+			unsigned v = graph.succ[e];
+			if(v < lo)
+				continue;
+			ull bit = v - lo;
+			if(acc[bit/64] & ((uint64_t)1 << (bit%64)))
+				redundant[e] = 1;
+		}
+		for(e=graph.succOffset[u]; e<end; e++) {
+			unsigned v = graph.succ[e];
+			if(v < lo)
+				continue;
+			ull bit = v - lo;
+			acc[bit/64] |= (uint64_t)1 << (bit%64);
+			any = true;
+		}
+		nonEmpty[u] = any;
+	}
+}
+
+/*
+ * State shared by the worker threads for one reduction
+ */
+struct ReductionState {
+	CSRGraph *graph;
+	ull n;
+	ull block;
+	ull blocks;
+	atomic<ull> next;
+	//each edge belongs to the block of its target, so threads never write the same entry
+	vector<char> redundant;
+};
+
+/*
+ * Takes blocks until none are left. Later blocks cover more nodes, so they
+ * are handed out first.
+ */
+static void worker(ReductionState *s) {
+	vector<uint64_t> bits;
+	vector<char> nonEmpty;
+	for(ull b=s->next++; b<s->blocks; b=s->next++) {
+		ull lo = (s->blocks-1-b)*s->block;
+		ull hi = min(lo+s->block,s->n);
+		reduceBlock(*s->graph,lo,hi,bits,nonEmpty,s->redundant);
+	}
+}
+
+TransitiveReduction::TransitiveReduction(unsigned threads) {
+	if(threads == 0)
+		threads = thread::hardware_concurrency();
+	this->threads = (threads > 0) ? threads : 1;
+	blockSize = 0;
+	memoryLimit = 64*1024*1024;
+	removed = 0;
+}
+
+/*
+ * Builds the transitive reduction of graph into reduced and returns the
+ * number of edges removed. Node types and memory accesses are kept
+ * unchanged.
+ */
+long long unsigned TransitiveReduction::reduce(CSRGraph &graph, CSRGraph &reduced) {
+	ull n = graph.nodes;
+
+	ull block = blockSize;
+	if(block == 0) {
+		block = (n > 0) ? memoryLimit*8 / n : 64;
+		block = min(max(block,(ull)64),(ull)65536);
+	}
+	block = (block + 63) / 64 * 64;
+
+	ReductionState s;
+	s.graph = &graph;
+	s.n = n;
+	s.block = block;
+	s.blocks = (n + block - 1) / block;
+	s.next = 0;
+	s.redundant.assign(graph.edges,0);
+
+	unsigned workers = (unsigned)min((ull)threads,max(s.blocks,(ull)1));
+	vector<thread> pool;
+	for(unsigned t=1; t<workers; t++)
+		pool.push_back(thread(worker,&s));
+	worker(&s);
+	for(unsigned t=0; t<pool.size(); t++)
+		pool[t].join();
+
+	vector<pair<unsigned,unsigned> > edgeList;
+	removed = 0;
+	for(ull u=0; u<n; u++) {
+		for(ull e=graph.succOffset[u]; e<graph.succOffset[u+1]; e++) {
+			if(s.redundant[e])
+				removed++;
+			else
+				edgeList.push_back(pair<unsigned,unsigned>(u,graph.succ[e]));
+		}
+	}
+
+	vector<int> types(graph.type);
+	reduced.build(n,types,edgeList);
+	reduced.memory = graph.memory;
+
+	return removed;
+}
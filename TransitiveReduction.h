@@ -0,0 +1,56 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ *
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * TransitiveReduction.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+
+#include "CSRGraph.h"
+
+#ifndef _TRANSITIVEREDUCTION_
+#define _TRANSITIVEREDUCTION_
+
+using namespace std;
+
+/*
+ * Removes every edge u->v of a traced graph that is implied by a longer
+ * path from u to v. Relies on node ids being a topological order: the
+ * descendants of each node are kept as bitsets over one block of target
+ * ids at a time, built in a single reverse pass over the nodes, so memory
+ * stays bounded for large graphs. Blocks are independent and are spread
+ * over the threads.
+ */
+class TransitiveReduction {
+public:
+	unsigned threads;
+	//target ids per block (a multiple of 64), 0 picks one from memoryLimit
+	long long unsigned blockSize;
+	//bytes of bitsets each thread may use when picking the block size
+	long long unsigned memoryLimit;
+
+	//edges removed by the last reduction
+	long long unsigned removed;
+
+	TransitiveReduction(unsigned threads = 0);
+
+	long long unsigned reduce(CSRGraph &graph, CSRGraph &reduced);
+};
+
+#endif
@@ -24,11 +24,21 @@
 #include <string>
 #include <fstream>
 #include <set>
+#include <map>
 #include <sstream>
+#include <unordered_map>
+#include <algorithm>
+
+#include <string.h>
 
 #include "Graph.h"
+#include "MemoryModel.h"
 #include "SparseMatrix.h"
 #include "SparseSet.h"
+#include "CompressedGraph.h"
+#include "TraceScope.h"
+#include "SourceLocations.h"
+#include "TraceRegion.h"
 
 using namespace std;
 
@@ -40,18 +50,80 @@ extern long long unsigned currentNodes;
 extern bool maxOverflow;
 extern bool currentOverflow;
 
+/*
+ * An op and its operands, as identified by Data::operandKey
+ */
+struct CSEKey {
+	int op;
+	long long unsigned a;
+	long long unsigned b;
+
+	//both operands depend only on constants (not part of the identity)
+	bool constant;
+
+	bool operator==(const CSEKey &oth) const {
+		return op == oth.op && a == oth.a && b == oth.b;
+	}
+};
+
+struct CSEKeyHash {
+	size_t operator()(const CSEKey &k) const {
+		long long unsigned h = k.a * 0x9E3779B97F4A7C15ULL;
+		h ^= k.b + 0x7F4A7C159E3779B9ULL + (h << 6) + (h >> 2);
+		h ^= (long long unsigned)k.op * 0xC2B2AE3D27D4EB4FULL;
+		return (size_t)(h ^ (h >> 29));
+	}
+};
+
+template <class T>
+class MultExpr;
+
+template <class T>
+class Data;
+
+/*
+ * The right operand of a binary or compound assignment op (or the operand
+ * of a negation) together with the source line of the expression using
+ * it. Operators cannot take default arguments, so the line is captured by
+ * the implicit conversion from Data instead, the same way
+ * std::source_location::current() would be.
+ */
+template <class T>
+class Located {
+public:
+	Data<T> &data;
+
+	Located(Data<T> &d, const char *file = __builtin_FILE(), unsigned line = __builtin_LINE()) : data(d) {
+		if(Data<T>::provenance)
+			Data<T>::setLocation(file,line);
+	}
+
+	//the result of another op lives until the end of the expression using it
+	Located(Data<T> &&d, const char *file = __builtin_FILE(), unsigned line = __builtin_LINE()) : data(d) {
+		if(Data<T>::provenance)
+			Data<T>::setLocation(file,line);
+	}
+};
+
 template <class T>
 class Data {
+	friend class MultExpr<T>;
+	friend class Located<T>;
+
 public:
 	bool calculated;
 	bool read;
 	long long unsigned node;
+	long long unsigned addr;
 	static bool debug;
 
 	Data() {
 		calculated = false;
 		read = false;
 		node = 0;
+		holding = false;
+		addr = memAddress;
+		memAddress += sizeof(T);
 		ID = count++;
 		value = new T;
 		if(debug) printf("Created Data #%llu\n",ID);
@@ -61,6 +133,8 @@ public:
 		calculated = false;
 		read = true;
 		node = 0;
+		holding = false;
+		addr = 0;
 		ID = count++;
 		value = new T;
 		*value = val;
@@ -71,14 +145,26 @@ public:
 		calculated = oth.calculated;
 		read = oth.read;
 		node = oth.node;
+		holding = false;
+		if(oth.holding)
+			setNode(oth.node);
+		addr = oth.addr;
 		ID = count++;
 		value = new T;
 		*value = *(oth.value);
 		if(debug) printf("Created copy Data #%llu from Data #%llu\n",ID,oth.ID);
 	}
 
+	/*
+	 * A product is only traced once it is used, see MultExpr
+	 */
+	Data(const MultExpr<T> &e) : Data(e.a.product(e.b)) {
+	}
+
 	~Data() {
 		if(debug) printf("Attempting to Destroy Data #%llu\n",ID);
+		if(holding)
+			release(node);
 		delete(value);
 		if(debug) printf("Destroyed Data #%llu\n",ID);
 	}
@@ -86,16 +172,21 @@ public:
 	void setData(Data &oth) {
 		calculated = oth.calculated;
 		read = oth.read;
-		node = oth.node;
+		copyNode(oth);
+		addr = oth.addr;
 		ID = count++;
-		value = new T;
 		*value = *(oth.value);
 	}
 
-	Data operator-() {
-		Data oth(*this);
+	/*
+	 * Negation traces no op, but takes a Located operand so a line that
+	 * starts with one still becomes the location of its ops
+	 */
+	friend Data operator-(Located<T> src) {
+		Data &d1 = src.data;
+		Data oth(d1);
 
-		*oth.value = -(*(value));
+		*oth.value = -(*(d1.value));
 
 		return oth;
 	}
@@ -105,9 +196,9 @@ public:
 
 		read = d1.read;
 		calculated = d1.calculated;
-		node = d1.node;
+		addr = d1.addr;
+		copyNode(d1);
 
-		value = new T;
 		*value = *(d1.value);
 
 		return *this;
@@ -118,40 +209,50 @@ public:
 
 		read = d1.read;
 		calculated = d1.calculated;
-		node = d1.node;
+		addr = d1.addr;
+		copyNode(d1);
 
-		value = new T;
 		*value = *(d1.value);
 
 		return *this;
 	}
 
-	Data operator+(Data &d1) {
+	Data& operator=(const MultExpr<T> &e) {
+		Data p = e.a.product(e.b);
+		return *this = p;
+	}
+
+	Data operator+(Located<T> src) {
+		Data &d1 = src.data;
 		Data oth(*this);
 		oth.calculated = true;
 
 		if(debug) printf("Data #%llu = Data #%llu + Data #%llu\n",oth.ID,ID,d1.ID);
 
-		twoOperand(oth,d1);
-
-		//set operation type
-		matrix.setData(oth.node,oth.node,Types::Add + matrix.get(oth.node,oth.node));
+		twoOperand(oth,d1,Types::Add);
 
 		*oth.value = *(value) + *(d1.value);
 
 		return oth;
 	}
 
+	Data operator+(const MultExpr<T> &e) {
+		if(fmaCapture)
+			return multiplyAdd(e.a,e.b,*this);
+		Data p = e.a.product(e.b);
+		return *this + p;
+	}
+
 	/*
-	 * This function is used for adding the results of intermediate calculations
+	 * This function is used for adding another defined variable or the
+	 * results of intermediate calculations
 	 */
-	Data& operator+=(Data d1) {
+	Data& operator+=(Located<T> src) {
+		Data &d1 = src.data;
 		if(debug) printf("Data #%llu += Data #%llu\n",ID,d1.ID);
 		calculated = true;
-		oneOperand(d1);
 
-		//set operation type
-		matrix.setData(node,node,Types::Add + matrix.get(node,node));
+		oneOperand(d1,Types::Add);
 
 		*value += *(d1.value);
 
@@ -159,142 +260,163 @@ public:
 	}
 
 	/*
-	 * This function is used for adding another defined variable
+	 * Accumulates a product, as one FMA node when FMA capture is on
 	 */
-	Data& operator+=(Data &d1) {
-		if(debug) printf("Data #%llu += Data #%llu\n",ID,d1.ID);
-		calculated = true;
-
-		oneOperand(d1);
-
-		//set operation type
-		matrix.setData(node,node,Types::Add + matrix.get(node,node));
+	Data& operator+=(const MultExpr<T> &e) {
+		if(!fmaCapture || !recording) {
+			Data p = e.a.product(e.b);
+			if(debug) printf("Data #%llu += Data #%llu\n",ID,p.ID);
+			calculated = true;
+			oneOperand(p,Types::Add);
+			*value += *(p.value);
+			return *this;
+		}
 
-		*value += *(d1.value);
+		Data r = multiplyAdd(e.a,e.b,*this);
+		calculated = true;
+		copyNode(r);
+		*value = *(r.value);
 
 		return *this;
 	}
 
-	Data operator-(Data &d1) {
+	Data operator-(Located<T> src) {
+		Data &d1 = src.data;
 		Data oth(*this);
 		oth.calculated = true;
 
 		if(debug) printf("Data #%llu = Data #%llu - Data #%llu\n",oth.ID,ID,d1.ID);
 
-		twoOperand(oth,d1);
-
-		//set operation type
-		matrix.setData(oth.node,oth.node,Types::Sub + matrix.get(oth.node,oth.node));
+		twoOperand(oth,d1,Types::Sub);
 
 		*oth.value = *(value) - *(d1.value);
 
 		return oth;
 	}
 
-	Data& operator-=(Data &d1) {
+	Data operator-(const MultExpr<T> &e) {
+		Data p = e.a.product(e.b);
+		return *this - p;
+	}
+
+	Data& operator-=(Located<T> src) {
+		Data &d1 = src.data;
 		if(debug) printf("Data #%llu -= Data #%llu\n",ID,d1.ID);
 		calculated = true;
 
-		oneOperand(d1);
-
-		//set operation type
-		matrix.setData(node,node,Types::Sub + matrix.get(node,node));
+		oneOperand(d1,Types::Sub);
 
 		*value -= *(d1.value);
 
 		return *this;
 	}
 
-	Data operator*(Data &d1) {
-		Data oth(*this);
-		oth.calculated = true;
-
-		if(debug) printf("Data #%llu = Data #%llu * Data #%llu\n",oth.ID,ID,d1.ID);
-
-		twoOperand(oth,d1);
-
-		//set operation type
-		int val = Types::Mult + matrix.get(oth.node,oth.node);
-		if(debug) printf("Node info: %d\n",val);
-		matrix.setData(oth.node,oth.node,val);
+	Data& operator-=(const MultExpr<T> &e) {
+		Data p = e.a.product(e.b);
+		return *this -= p;
+	}
 
-		*oth.value = *(value) * *(d1.value);
+	/*
+	 * Products are expression templates: nothing is traced until the
+	 * product is assigned or used in another op, so a * b + c can become a
+	 * single FMA node (see setFMA)
+	 */
+	MultExpr<T> operator*(Located<T> src) {
+		return MultExpr<T>(*this,src.data);
+	}
 
-		return oth;
+	Data operator*(const MultExpr<T> &e) {
+		Data p = e.a.product(e.b);
+		return product(p);
 	}
 
-	Data& operator*=(const Data &d1) {
+	Data& operator*=(Located<T> src) {
+		Data &d1 = src.data;
 		if(debug) printf("Data #%llu *= Data #%llu\n",ID,d1.ID);
 		calculated = true;
 
-		oneOperand(d1);
-
-		//set operation type
-		matrix.setData(node,node,Types::Mult + matrix.get(node,node));
+		oneOperand(d1,Types::Mult);
 
 		*value *= *(d1.value);
 
 		return *this;
 	}
 
-	Data operator/(Data &d1) {
+	Data& operator*=(const MultExpr<T> &e) {
+		Data p = e.a.product(e.b);
+		return *this *= p;
+	}
+
+	Data operator/(Located<T> src) {
+		Data &d1 = src.data;
 		Data oth(*this);
 		oth.calculated = true;
 
 		if(debug) printf("Data #%llu = Data #%llu / Data #%llu\n",oth.ID,ID,d1.ID);
 
-		twoOperand(oth,d1);
-
-		//set operation type
-		matrix.setData(oth.node,oth.node,Types::Div + matrix.get(oth.node,oth.node));
+		twoOperand(oth,d1,Types::Div);
 		if(*d1.value != 0)
 			*(oth.value) = *(value) / *(d1.value);
 
 		return oth;
 	}
 
-	Data& operator/=(const Data &d1) {
+	Data operator/(const MultExpr<T> &e) {
+		Data p = e.a.product(e.b);
+		return *this / p;
+	}
+
+	Data& operator/=(Located<T> src) {
+		Data &d1 = src.data;
 		if(debug) printf("Data #%llu /= Data #%llu\n",ID,d1.ID);
 		calculated = true;
 
-		oneOperand(d1);
-
-		//set operation type
-		matrix.setData(node,node,Types::Div + matrix.get(node,node));
+		oneOperand(d1,Types::Div);
 
 		*value /= *(d1.value);
 
 		return *this;
 	}
 
-	Data operator%(Data &d1) {
+	Data& operator/=(const MultExpr<T> &e) {
+		Data p = e.a.product(e.b);
+		return *this /= p;
+	}
+
+	Data operator%(Located<T> src) {
+		Data &d1 = src.data;
 		Data oth(*this);
 		oth.calculated = true;
 
 		if(debug) printf("Data #%llu = Data #%llu % Data #%llu\n",oth.ID,ID,d1.ID);
 
-		twoOperand(oth,d1);
-
-		//set operation type
-		matrix.setData(oth.node,oth.node,Types::Mod + matrix.get(oth.node,oth.node));
+		twoOperand(oth,d1,Types::Mod);
 
 		*oth.value = *(value) % *(d1.value);
 
 		return oth;
 	}
 
-	Data& operator%=(const Data &d1) {
-		if(debug) printf("Data #%llu + Data #%llu\n",ID,d1.ID);
-		calculated = true;
+	Data operator%(const MultExpr<T> &e) {
+		Data p = e.a.product(e.b);
+		return *this % p;
+	}
 
-		oneOperand(d1);
+	Data& operator%=(Located<T> src) {
+		Data &d1 = src.data;
+		if(debug) printf("Data #%llu %%= Data #%llu\n",ID,d1.ID);
+		calculated = true;
 
-		//set operation type
-		matrix.setData(node,node,Types::Mod + matrix.get(node,node));
+		oneOperand(d1,Types::Mod);
 
 		*value %= *(d1.value);
 
-		return this;
+		return *this;
+	}
+
+	Data& operator%=(const MultExpr<T> &e) {
+		Data p = e.a.product(e.b);
+		return *this %= p;
 	}
 
 	bool operator<(const Data &d1) {
@@ -348,6 +470,162 @@ public:
 			cout << "Max Nodes: OVERFLOW!" << endl;
 		else
 			cout << "Max Nodes: " << maxNodes << endl;
+
+		if(cse)
+			cout << "Deduplicated Ops: " << deduplicated << endl;
+
+		if(pruning)
+			cout << "Pruned Ops: " << pruned << endl;
+
+		if(reducing)
+			cout << "Reduced Ops: " << reduced << endl;
+
+		if(fmaCapture)
+			cout << "FMA Ops: " << fmas << endl;
+	}
+
+	/*
+	 * Appends every traced op to the compressed graph as it is created,
+	 * without keepMatrix the sparse matrix is not built at all so traces far
+	 * larger than memory can be analyzed in compressed form. Dead node
+	 * elimination only applies to the matrix. Call finish() on the compressed
+	 * graph once tracing is done.
+	 */
+	static void setCompressor(CompressedGraph *graph, bool keep = false) {
+		compressor = graph;
+		keepMatrix = keep;
+	}
+
+	/*
+	 * Turns on common subexpression detection: an op applied to operands it
+	 * was already traced with reuses the existing node instead of creating a
+	 * new one (Add and Mult match with their operands in either order).
+	 * Operands match when they are the same node, read from the same address
+	 * or are equal values computed only from constants. Values are still
+	 * computed as usual.
+	 */
+	static void setCSE(bool enable) {
+		cse = enable;
+	}
+
+	static long long unsigned getDeduplicated() {
+		return deduplicated;
+	}
+
+	/*
+	 * Marks this variable's value as a result of the program. Only nodes
+	 * that can reach a result are needed, see CSRGraph::prune and
+	 * setPruning.
+	 */
+	void markOutput() {
+		if(!calculated)
+			return;
+		outputs.push_back(node);
+		if(pruning) {
+			trackNode(node);
+			nodeState[node] = OutputNode;
+		}
+	}
+
+	static vector<long long unsigned>& getOutputs() {
+		return outputs;
+	}
+
+	/*
+	 * Turns on online dead node elimination: every node counts the variables
+	 * holding its value and the ops consuming it, and once both reach zero
+	 * (and it is not marked as an output) it is removed from the graph along
+	 * with any of its operands that become dead in turn. Removed ids are left
+	 * as gaps, CSRGraph::prune compacts them. Must be called before any
+	 * operations are traced. Current and Max Nodes in printStats become the
+	 * live and peak live node counts.
+	 */
+	static void setPruning(bool enable) {
+		pruning = enable;
+	}
+
+	static long long unsigned getPruned() {
+		return pruned;
+	}
+
+	/*
+	 * Turns on collapsing of reduction trees while tracing: once no variable
+	 * holds an Add/Sub node and its only consumer is an Add/Sub (or Reduce)
+	 * node, it is merged into that consumer, which becomes an n-ary Reduce
+	 * node. Balanced trees and accumulation chains both end up as one node.
+	 * Uses the bookkeeping of dead node elimination, so this also turns on
+	 * setPruning. Only affects the sparse matrix, see ReductionTrees for the
+	 * same on a finished graph.
+	 */
+	static void setReduce(bool enable) {
+		reducing = enable;
+		if(enable)
+			pruning = true;
+	}
+
+	static long long unsigned getReduced() {
+		return reduced;
+	}
+
+	/*
+	 * Turns on FMA capture: a product that is added to a value (a * b + c,
+	 * c + a * b or c += a * b) is traced as one FMA node with all three
+	 * operands instead of a Mult node feeding an Add node. Other uses of a
+	 * product trace the Mult node as usual. Not combined with common
+	 * subexpression detection, FMA nodes are never deduplicated.
+	 */
+	static void setFMA(bool enable) {
+		fmaCapture = enable;
+	}
+
+	static long long unsigned getFMAs() {
+		return fmas;
+	}
+
+	/*
+	 * Records the source line that created every traced op (the line of
+	 * the expression using the op's right operand, see Located), as a
+	 * 4 byte SourceLocations id per node. Pass getLocations() with the
+	 * traced graph to SourceLocations::analyze for the per line report.
+	 */
+	static void setProvenance(bool enable) {
+		provenance = enable;
+	}
+
+	static vector<unsigned>& getLocations() {
+		return nodeLocations;
+	}
+
+	/*
+	 * Writes one line per Reduce node: node arity depth memory, where memory
+	 * is the exact number of accesses of all the ops folded into it
+	 */
+	static void writeReductions(string filename) {
+		FILE *fp = fopen(filename.c_str(),"w");
+		if(fp == NULL) {
+			printf("Unable to open %s for writing\n",filename.c_str());
+			return;
+		}
+
+		map<long long unsigned,pair<long long unsigned,long long unsigned> > sorted(reduceShapes.begin(),reduceShapes.end());
+		typename map<long long unsigned,pair<long long unsigned,long long unsigned> >::iterator it;
+		for(it=sorted.begin(); it != sorted.end(); it++)
+			if(nodeState[it->first] != DeadNode)
+				fprintf(fp,"%llu %llu %llu %llu\n",it->first,it->second.first,it->second.second,reduceMemory(it->first,matrix.get(it->first,it->first)));
+
+		fclose(fp);
+	}
+
+	/*
+	 * The type of a node holds at most 4 memory accesses, gives the Reduce
+	 * nodes of a graph built from the sparse matrix their exact counts
+	 * (see CSRGraph::setMemory)
+	 */
+	static void exactMemory(CSRGraph &graph) {
+		typename unordered_map<long long unsigned,long long unsigned>::iterator it;
+		for(it=reduceMemories.begin(); it != reduceMemories.end(); it++)
+			if(it->first < graph.nodes && nodeState[it->first] != DeadNode && it->second > 4)
+				graph.setMemory(it->first,it->second);
 	}
 
 	static void writeSparseMatrix(string filename) {
@@ -377,6 +655,13 @@ public:
 		myfile.close();
 	}
 
+	/*
+	 * Returns the traced graph, eg. for building a CSRGraph for analysis
+	 */
+	static SparseMatrix* getMatrix() {
+		return &matrix;
+	}
+
 	static void writeResult(string filename) {
 	  string file = filename + ".txt";
 	  writeMatrix(file);
@@ -388,111 +673,813 @@ private:
 	static long long unsigned count;
 	static SparseMatrix matrix;
 
-	void oneOperand(Data &d1) {
+	//compressed graph every new node is streamed into, and whether the
+	//sparse matrix is still filled as well
+	static CompressedGraph *compressor;
+	static bool keepMatrix;
+
+	//common subexpression detection: whether it is on, ops reused, nodes by
+	//(op, operands), ids given to constant operand values and which nodes
+	//depend only on constants
+	static bool cse;
+	static long long unsigned deduplicated;
+	static unordered_map<CSEKey,long long unsigned,CSEKeyHash> cseNodes;
+	static map<T,long long unsigned> constants;
+	static vector<bool> constantNodes;
+
+	//dead node elimination: whether it is on, ops removed, result nodes,
+	//and per node the variables holding it, ops consuming it, its operand
+	//nodes and whether it is live, an output or dead
+	enum NodeState { LiveNode, OutputNode, DeadNode };
+	static bool pruning;
+	static long long unsigned pruned;
+	static vector<long long unsigned> outputs;
+	static vector<unsigned> holders;
+	static vector<unsigned> consumers;
+	static vector<pair<long long unsigned,long long unsigned> > operandNodes;
+	static vector<char> nodeState;
+
+	static bool fmaCapture;
+	static long long unsigned fmas;
+
+	//source location of the expression being traced and of each node
+	static bool provenance;
+	static unsigned location;
+	static const char *locationFile;
+	static unsigned locationLine;
+	static vector<unsigned> nodeLocations;
+
+	/*
+	 * Makes the given line the location of the ops traced from now on,
+	 * lines of this header are skipped so ops traced by its own helpers
+	 * keep the line of the user's expression
+	 */
+	static void setLocation(const char *file, unsigned line) {
+		if(file == locationFile && line == locationLine)
+			return;
+		if(strcmp(file,__FILE__) == 0)
+			return;
+
+		locationFile = file;
+		locationLine = line;
+		location = SourceLocations::intern(file,line);
+	}
+
+	//collapsing of reduction trees into Reduce nodes while tracing
+	static bool reducing;
+	static long long unsigned reduced;
+	static vector<long long unsigned> consumerNode;
+	//operands of nodes with more than two of them
+	static unordered_map<long long unsigned,vector<long long unsigned> > naryOperands;
+	static unordered_map<long long unsigned,pair<long long unsigned,long long unsigned> > reduceShapes;
+	//binary ops from each operand of a Reduce node to its result, in operand order
+	static unordered_map<long long unsigned,vector<long long unsigned> > reduceLevels;
+	//memory accesses of each Reduce node, which can be more than its type holds
+	static unordered_map<long long unsigned,long long unsigned> reduceMemories;
+
+	//this variable holds a reference on node
+	bool holding;
+
+	static void trackNode(long long unsigned n) {
+		if(holders.size() <= n) {
+			holders.resize(n+1,0);
+			consumers.resize(n+1,0);
+			consumerNode.resize(n+1,0);
+			operandNodes.resize(n+1,pair<long long unsigned,long long unsigned>(n,n));
+			nodeState.resize(n+1,LiveNode);
+		}
+	}
+
+	static void addNode(long long unsigned n) {
+		trackNode(n);
+		operandNodes[n] = pair<long long unsigned,long long unsigned>(n,n);
+		currentNodes++;
+		if(currentNodes > maxNodes)
+			maxNodes = currentNodes;
+	}
+
+	//records the edge from operand node to n (an operand used twice is one edge)
+	static void addConsumer(long long unsigned operand, long long unsigned n) {
+		pair<long long unsigned,long long unsigned> &ops = operandNodes[n];
+		if(ops.first == operand || ops.second == operand)
+			return;
+		if(ops.first == n)
+			ops.first = operand;
+		else if(ops.second == n)
+			ops.second = operand;
+		else {
+			//a third operand, the full list is kept with the n-ary nodes
+			vector<long long unsigned> &all = naryOperands[n];
+			if(all.empty()) {
+				all.push_back(ops.first);
+				all.push_back(ops.second);
+			}
+			if(find(all.begin(),all.end(),operand) != all.end())
+				return;
+			all.push_back(operand);
+		}
+		consumers[operand]++;
+		consumerNode[operand] = n;
+	}
+
+	static void hold(long long unsigned n) {
+		trackNode(n);
+		holders[n]++;
+	}
+
+	static void release(long long unsigned n) {
+		holders[n]--;
+
+		//remove n and then any operands left without holders or consumers
+		vector<long long unsigned> stack(1,n);
+		while(!stack.empty()) {
+			long long unsigned d = stack.back();
+			stack.pop_back();
+			if(nodeState[d] != LiveNode || holders[d] != 0)
+				continue;
+			if(consumers[d] != 0) {
+				if(consumers[d] == 1 && reducing)
+					fold(d,stack);
+				continue;
+			}
+
+			if(debug) printf("Pruning dead Op#%llu\n",d);
+			nodeState[d] = DeadNode;
+			matrix.remove(d,d);
+			pruned++;
+			currentNodes--;
+
+			vector<long long unsigned> ops = operandsOf(d);
+			for(unsigned k=0; k<ops.size(); k++) {
+				matrix.remove(ops[k],d);
+				consumers[ops[k]]--;
+				stack.push_back(ops[k]);
+			}
+		}
+	}
+
+	static vector<long long unsigned> operandsOf(long long unsigned n) {
+		typename unordered_map<long long unsigned,vector<long long unsigned> >::iterator it = naryOperands.find(n);
+		if(it != naryOperands.end())
+			return it->second;
+
+		vector<long long unsigned> ops;
+		if(operandNodes[n].first != n)
+			ops.push_back(operandNodes[n].first);
+		if(operandNodes[n].second != n)
+			ops.push_back(operandNodes[n].second);
+		return ops;
+	}
+
+	//binary ops between each operand of n and its result
+	static vector<long long unsigned> levelsOf(long long unsigned n, unsigned operands) {
+		typename unordered_map<long long unsigned,vector<long long unsigned> >::iterator it = reduceLevels.find(n);
+		if(it != reduceLevels.end())
+			return it->second;
+		return vector<long long unsigned>(operands,1);
+	}
+
+	static bool isSum(int value) {
+		int op = Types::getOpType(value);
+		return op == Types::Add || op == Types::Sub || op == Types::Reduce;
+	}
+
+	/*
+	 * Merges the Add/Sub node n, which no variable holds anymore, into the
+	 * Add/Sub/Reduce node that is its only consumer. The consumer becomes a
+	 * Reduce node taking n's operands and memory accesses. Operands whose
+	 * consumer count drops are pushed on the stack to be checked again.
+	 */
+	static void fold(long long unsigned n, vector<long long unsigned> &stack) {
+		long long unsigned c = consumerNode[n];
+		if(nodeState[c] == DeadNode || matrix.get(n,c) == 0)
+			return;
+		int nValue = matrix.get(n,n);
+		int cValue = matrix.get(c,c);
+		if(!isSum(nValue) || !isSum(cValue))
+			return;
+
+		if(debug) printf("Folding Op#%llu into Op#%llu\n",n,c);
+
+		vector<long long unsigned> ops = operandsOf(c);
+		vector<long long unsigned> levels = levelsOf(c,ops.size());
+		unsigned at = find(ops.begin(),ops.end(),n) - ops.begin();
+		//n's operands are that many more ops away from c's result
+		long long unsigned above = levels[at];
+		ops.erase(ops.begin()+at);
+		levels.erase(levels.begin()+at);
+		matrix.remove(n,c);
+
+		vector<long long unsigned> nOps = operandsOf(n);
+		vector<long long unsigned> nLevels = levelsOf(n,nOps.size());
+		for(unsigned k=0; k<nOps.size(); k++) {
+			long long unsigned o = nOps[k];
+			matrix.remove(o,n);
+			unsigned j = find(ops.begin(),ops.end(),o) - ops.begin();
+			if(j < ops.size()) {
+				//already an operand of c, the two edges become one
+				consumers[o]--;
+				stack.push_back(o);
+				levels[j] = max(levels[j],above + nLevels[k]);
+			}
+			else {
+				matrix.setNew(o,c,1);
+				consumerNode[o] = c;
+				ops.push_back(o);
+				levels.push_back(above + nLevels[k]);
+			}
+		}
+		naryOperands[c] = ops;
+
+		pair<long long unsigned,long long unsigned> nShape = reduceShape(n);
+		pair<long long unsigned,long long unsigned> cShape = reduceShape(c);
+		cShape.first += nShape.first - 1;
+		//memory reads are not nodes, so take the depth from n rather than its operands
+		if(cShape.second < above + nShape.second)
+			cShape.second = above + nShape.second;
+		reduceShapes[c] = cShape;
+		reduceLevels[c] = levels;
+		long long unsigned mem = reduceMemory(n,nValue) + reduceMemory(c,cValue);
+		reduceMemories[c] = mem;
+		reduceShapes.erase(n);
+		reduceLevels.erase(n);
+		reduceMemories.erase(n);
+		naryOperands.erase(n);
+
+		//the type holds at most 4 memory accesses, see exactMemory
+		matrix.setData(c,c,Types::setMemType(mem > 4 ? 4 : mem) + Types::Reduce);
+		matrix.remove(n,n);
+
+		nodeState[n] = DeadNode;
+		consumers[n] = 0;
+		reduced++;
+		currentNodes--;
+	}
+
+	//memory accesses of node n with the given type, exact for Reduce nodes
+	static long long unsigned reduceMemory(long long unsigned n, int value) {
+		typename unordered_map<long long unsigned,long long unsigned>::iterator it = reduceMemories.find(n);
+		if(it != reduceMemories.end())
+			return it->second;
+		return Types::getMemType(value);
+	}
+
+	//arity and depth of node n, a binary op unless it is a Reduce node
+	static pair<long long unsigned,long long unsigned> reduceShape(long long unsigned n) {
+		typename unordered_map<long long unsigned,pair<long long unsigned,long long unsigned> >::iterator it = reduceShapes.find(n);
+		if(it != reduceShapes.end())
+			return it->second;
+		return pair<long long unsigned,long long unsigned>(2,1);
+	}
+
+	/*
+	 * Points this variable at node n, holding a reference on it when dead
+	 * node elimination is on
+	 */
+	void setNode(long long unsigned n) {
+		if(pruning) {
+			hold(n);
+			if(holding)
+				release(node);
+			holding = true;
+		}
+		node = n;
+	}
+
+	void copyNode(const Data &oth) {
+		if(oth.holding) {
+			setNode(oth.node);
+		}
+		else {
+			if(holding)
+				release(node);
+			holding = false;
+			node = oth.node;
+		}
+	}
+
+	/*
+	 * Returns true if reading this variable costs a memory access. Constants
+	 * (addr 0) never do, otherwise the memory model decides, or without one
+	 * only the first read of the variable does.
+	 */
+	bool memoryAccess() {
+		if(memoryModel != NULL)
+			return addr != 0 && !memoryModel->access(addr);
+
+		if(read)
+			return false;
+
+		read = true;
+		return true;
+	}
+
+	/*
+	 * True if the value depends only on constants (no memory reads anywhere
+	 * before it), so equal values are interchangeable
+	 */
+	bool constantValue() {
+		if(calculated)
+			return node < constantNodes.size() && constantNodes[node];
+		return addr == 0;
+	}
+
+	/*
+	 * Identifies the value an operand holds for common subexpression
+	 * detection: the node that computed it, the address it is read from, or
+	 * for constants and values computed only from constants the value
+	 * itself. The top two bits keep the kinds apart.
+	 */
+	long long unsigned operandKey() {
+		if(constantValue()) {
+			typename map<T,long long unsigned>::iterator it = constants.find(*value);
+			if(it == constants.end())
+				it = constants.insert(pair<T,long long unsigned>(*value,constants.size())).first;
+			return it->second | ((long long unsigned)2 << 62);
+		}
+		if(calculated)
+			return node;
+		return addr | ((long long unsigned)1 << 62);
+	}
+
+	/*
+	 * Looks up op applied to the operands, returns true (with the existing
+	 * node) if it was traced before, otherwise fills in the key to record the
+	 * new node under
+	 */
+	static bool findCSE(int op, Data &d0, Data &d1, CSEKey &key, long long unsigned &existing) {
+		key.op = op;
+		key.constant = d0.constantValue() && d1.constantValue();
+		key.a = d0.operandKey();
+		key.b = d1.operandKey();
+		//Add and Mult give the same result with the operands swapped
+		if((op == Types::Add || op == Types::Mult) && key.b < key.a)
+			swap(key.a,key.b);
+
+		unordered_map<CSEKey,long long unsigned,CSEKeyHash>::iterator it = cseNodes.find(key);
+		if(it == cseNodes.end() || (pruning && nodeState[it->second] == DeadNode))
+			return false;
+
+		existing = it->second;
+		deduplicated++;
+		if(debug) printf("Reusing Op#%llu\n",existing);
+		return true;
+	}
+
+	static void addCSE(CSEKey &key, long long unsigned newNode) {
+		cseNodes[key] = newNode;
+		if(constantNodes.size() <= newNode)
+			constantNodes.resize(newNode+1,false);
+		constantNodes[newNode] = key.constant;
+	}
+
+	//records the edge from node to n, an operand used more than once is one edge
+	static void addEdge(long long unsigned node, long long unsigned n, long long unsigned *preds, unsigned &numPreds) {
+		for(unsigned k=0; k<numPreds; k++)
+			if(preds[k] == node)
+				return;
+		preds[numPreds++] = node;
+		if(compressor == NULL || keepMatrix)
+			matrix.setNew(node,n,1);
+	}
+
+	static void addOp(long long unsigned n, int value, long long unsigned *preds, unsigned numPreds) {
+		if(provenance) {
+			if(nodeLocations.size() <= n)
+				nodeLocations.resize(n+1,0);
+			nodeLocations[n] = location;
+		}
+		if(compressor != NULL)
+			compressor->append(value,preds,numPreds);
+		if(compressor == NULL || keepMatrix)
+			matrix.setNew(n,n,value);
+	}
+
+	Data product(Data &d1) {
+		Data oth(*this);
+		oth.calculated = true;
+
+		if(debug) printf("Data #%llu = Data #%llu * Data #%llu\n",oth.ID,ID,d1.ID);
+
+		twoOperand(oth,d1,Types::Mult);
+
+		*oth.value = *(value) * *(d1.value);
+
+		return oth;
+	}
+
+	static Data multiplyAdd(Data &a, Data &b, Data &c) {
+		if(!recording) {
+			Data oth;
+			*oth.value = *(a.value) * *(b.value) + *(c.value);
+			return oth;
+		}
+
+		Data oth(a);
+		oth.calculated = true;
+
+		if(debug) printf("Data #%llu = Data #%llu * Data #%llu + Data #%llu\n",oth.ID,a.ID,b.ID,c.ID);
+
+		//initialize number of memory accesses
+		int mem = 0;
+
+		//predecessors of the new node
+		long long unsigned preds[3];
+		unsigned numPreds = 0;
+
+		//set node number
+		if(pruning)
+			addNode(opCount);
+		oth.setNode(opCount++);
+
+		Data *ops[3] = {&a,&b,&c};
+		for(unsigned k=0; k<3; k++) {
+			if(!ops[k]->calculated) {	//this variable has just been created (ie. memory access)
+				if(ops[k]->memoryAccess()) {
+					if(debug) printf("Adding memory access (Data#%llu) for Op#%llu\n",ops[k]->ID,oth.node);
+					mem++;
+				}
+			}
+			else {	//this variable is the result of some other operation (ie. previous Op)
+				if(debug) printf("Creating edge between Op#%llu and Op#%llu\n",ops[k]->node,oth.node);
+				addEdge(ops[k]->node,oth.node,preds,numPreds);
+				if(pruning)
+					addConsumer(ops[k]->node,oth.node);
+			}
+		}
+
+		//set memory accesses & operation type
+		addOp(oth.node,Types::setMemType(mem) + Types::FMA,preds,numPreds);
+		fmas++;
+
+		*oth.value = *(a.value) * *(b.value) + *(c.value);
+
+		return oth;
+	}
+
+	/*
+	 * Makes this variable a fresh untraced value, for results computed
+	 * while recording is off: they enter the graph as memory reads
+	 */
+	void untrace() {
+		if(holding)
+			release(node);
+		holding = false;
+		calculated = false;
+		read = false;
+		node = 0;
+		addr = memAddress;
+		memAddress += sizeof(T);
+	}
+
+	void oneOperand(Data &d1, int op) {
+		if(!recording) {
+			untrace();
+			return;
+		}
+
+		//reuse an identical op if common subexpression detection is on
+		CSEKey key;
+		long long unsigned existing;
+		if(cse && findCSE(op,*this,d1,key,existing)) {
+			calculated = true;
+			setNode(existing);
+			return;
+		}
 
 		//initialize number of memory accesses
 		int mem = 0;
 
+		//predecessors of the new node
+		long long unsigned preds[2];
+		unsigned numPreds = 0;
+
 		//set node number
 		long unsigned tmpNode = opCount++;
+		if(pruning)
+			addNode(tmpNode);
 
 		//check first operand
 		if(!calculated) {	//this variable has just been created (ie. memory access)
-			if(!read) {	//variable has not already been read into cache (ie. memory not already accessed)
+			if(memoryAccess()) {	//variable is not already in on-chip memory (ie. memory accessed)
 				if(debug) printf("Adding memory access (Data#%llu) for Op#%llu\n",ID,tmpNode);
 				mem++;
-
-				read = true;
 			}
 		}
 		else {	//this variable is the result of some other operation (ie. previous Op)
 			if(debug) printf("Creating edge between Op#%llu and Op#%llu\n",node,tmpNode);
-			matrix.setNew(node,tmpNode,1);
+			addEdge(node,tmpNode,preds,numPreds);
+			if(pruning)
+				addConsumer(node,tmpNode);
 		}
 
 		//check second operand
 		if(!d1.calculated) {	//this variable has just been created (ie. memory access)
-			if(!d1.read) {	//variable has not already been read into cache (ie. memory not already accessed)
+			if(d1.memoryAccess()) {	//variable is not already in on-chip memory (ie. memory accessed)
 				if(debug) printf("Adding memory access (Data#%llu) for Op#%llu\n",d1.ID,tmpNode);
 				mem++;
-
-				d1.read = true;
 			}
 		}
 		else {	//this variable is the result of some other operation (ie. previous Op)
 			if(debug) printf("Creating edge between Op#%llu and Op#%llu\n",d1.node,tmpNode);
-			matrix.setNew(d1.node,tmpNode,1);
+			addEdge(d1.node,tmpNode,preds,numPreds);
+			if(pruning)
+				addConsumer(d1.node,tmpNode);
 		}
 
-		//set memory accesses
-		matrix.setNew(tmpNode,tmpNode,Types::setMemType(mem));
+		//set memory accesses & operation type
+		addOp(tmpNode,Types::setMemType(mem) + op,preds,numPreds);
 
 		//set this variable as a calculated variable (ie. not a memory access, has dependencies)
 		calculated = true;
 
 		//set the op node number
-		node = tmpNode;
+		setNode(tmpNode);
+
+		if(cse)
+			addCSE(key,tmpNode);
 
 		//cout << "Created node: " << node << endl;
 	}
 
-	void twoOperand(Data &oth, Data &d1) {
+	void twoOperand(Data &oth, Data &d1, int op) {
+		if(!recording) {
+			oth.untrace();
+			return;
+		}
+
 		//set this variable as a calculated variable (ie. not a memory access, has dependencies)
 		oth.calculated = true;
 
+		//reuse an identical op if common subexpression detection is on
+		CSEKey key;
+		long long unsigned existing;
+		if(cse && findCSE(op,*this,d1,key,existing)) {
+			oth.setNode(existing);
+			return;
+		}
+
 		//initialize number of memory accesses
 		int mem = 0;
 
+		//predecessors of the new node
+		long long unsigned preds[2];
+		unsigned numPreds = 0;
+
 		//set node number
-		oth.node = opCount++;
+		if(pruning)
+			addNode(opCount);
+		oth.setNode(opCount++);
 
 		//check first operand
 		if(!calculated) {	//this variable has just been created (ie. memory access)
-			if(!read) {	//variable has not already been read into cache (ie. memory not already accessed)
+			if(memoryAccess()) {	//variable is not already in on-chip memory (ie. memory accessed)
 				if(debug) printf("Adding memory access (Data#%llu) for Op#%llu\n",ID,oth.node);
 				mem++;
-
-				read = true;
 			}
 			else
 				if(debug) printf("Data#%llu already accessed for Op#%llu\n",ID,oth.node);
 		}
 		else {	//this variable is the result of some other operation (ie. previous Op)
 			if(debug) printf("Creating edge between Op#%llu and Op#%llu\n",node,oth.node);
-			matrix.setNew(node,oth.node,1);
+			addEdge(node,oth.node,preds,numPreds);
+			if(pruning)
+				addConsumer(node,oth.node);
 		}
 
 		//check second operand
 		if(!d1.calculated) {	//this variable has just been created (ie. memory access)
-			if(!d1.read) {	//variable has not already been read into cache (ie. memory not already accessed)
+			if(d1.memoryAccess()) {	//variable is not already in on-chip memory (ie. memory accessed)
 				if(debug) printf("Adding memory access (Data#%llu) for Op#%llu\n",d1.ID,oth.node);
 				mem++;
-
-				d1.read = true;
 			}
 			else
 				if(debug) printf("Data#%llu already accessed for Op#%llu\n",d1.ID,oth.node);
 		}
 		else {	//this variable is the result of some other operation (ie. previous Op)
 			if(debug) printf("Creating edge between Op#%llu and Op#%llu\n",d1.node,oth.node);
-			matrix.setNew(d1.node,oth.node,1);
+			addEdge(d1.node,oth.node,preds,numPreds);
+			if(pruning)
+				addConsumer(d1.node,oth.node);
 		}
 
-		//set memory accesses
-		matrix.setNew(oth.node,oth.node,Types::setMemType(mem));
+		//set memory accesses & operation type
+		addOp(oth.node,Types::setMemType(mem) + op,preds,numPreds);
+
+		if(cse)
+			addCSE(key,oth.node);
 
 		//cout << "Created node: " << oth.node << endl;
 	}
 };
 
+/*
+ * The product of two variables, traced only once it is used: converting
+ * it to a Data (assignment, initialization, any other op) traces the Mult
+ * node, adding it to a value can trace a single FMA node instead. It has
+ * the operators of Data, member functions need the product converted first
+ * (Data<T>(a*b).str()). Holds references to its operands so it must be
+ * used within the expression that created it: auto p = (a+b)*c keeps a
+ * reference to the destroyed a+b, declare p as a Data instead.
+ */
+template <class T>
+class MultExpr {
+public:
+	Data<T> &a;
+	Data<T> &b;
+
+	MultExpr(Data<T> &x, Data<T> &y) : a(x), b(y) {
+	}
+
+	Data<T> operator+(Located<T> src) const {
+		Data<T> &c = src.data;
+		if(Data<T>::fmaCapture)
+			return Data<T>::multiplyAdd(a,b,c);
+		Data<T> p = a.product(b);
+		return p + c;
+	}
+
+	Data<T> operator+(const MultExpr &e) const {
+		if(Data<T>::fmaCapture) {
+			Data<T> q = e.a.product(e.b);
+			return Data<T>::multiplyAdd(a,b,q);
+		}
+		Data<T> p = a.product(b);
+		return p + e;
+	}
+
+	Data<T> operator-(Located<T> src) const {
+		Data<T> &c = src.data;
+		Data<T> p = a.product(b);
+		return p - c;
+	}
+
+	Data<T> operator-(const MultExpr &e) const {
+		Data<T> p = a.product(b);
+		return p - e;
+	}
+
+	Data<T> operator*(Located<T> src) const {
+		Data<T> &c = src.data;
+		Data<T> p = a.product(b);
+		return p.product(c);
+	}
+
+	Data<T> operator*(const MultExpr &e) const {
+		Data<T> p = a.product(b);
+		return p * e;
+	}
+
+	Data<T> operator/(Located<T> src) const {
+		Data<T> &c = src.data;
+		Data<T> p = a.product(b);
+		return p / c;
+	}
+
+	Data<T> operator/(const MultExpr &e) const {
+		Data<T> p = a.product(b);
+		return p / e;
+	}
+
+	Data<T> operator%(Located<T> src) const {
+		Data<T> &c = src.data;
+		Data<T> p = a.product(b);
+		return p % c;
+	}
+
+	Data<T> operator%(const MultExpr &e) const {
+		Data<T> p = a.product(b);
+		return p % e;
+	}
+
+	Data<T> operator-() const {
+		Data<T> p = a.product(b);
+		return -p;
+	}
+
+	bool operator<(const Data<T> &c) const {
+		Data<T> p = a.product(b);
+		return p < c;
+	}
+
+	bool operator<=(const Data<T> &c) const {
+		Data<T> p = a.product(b);
+		return p <= c;
+	}
+
+	bool operator>(const Data<T> &c) const {
+		Data<T> p = a.product(b);
+		return p > c;
+	}
+
+	bool operator>=(const Data<T> &c) const {
+		Data<T> p = a.product(b);
+		return p >= c;
+	}
+
+	bool operator==(const Data<T> &c) const {
+		Data<T> p = a.product(b);
+		return p == c;
+	}
+
+	bool operator!=(const Data<T> &c) const {
+		Data<T> p = a.product(b);
+		return p != c;
+	}
+};
+
 template <class T>
 SparseMatrix Data<T>::matrix;
 
+template <class T>
+CompressedGraph* Data<T>::compressor = NULL;
+
+template <class T>
+bool Data<T>::keepMatrix = false;
+
 template <class T>
 long long unsigned Data<T>::count = 0;
 
 template <class T>
 bool Data<T>::debug = true;
 
+template <class T>
+bool Data<T>::cse = false;
+
+template <class T>
+long long unsigned Data<T>::deduplicated = 0;
+
+template <class T>
+unordered_map<CSEKey,long long unsigned,CSEKeyHash> Data<T>::cseNodes;
+
+template <class T>
+map<T,long long unsigned> Data<T>::constants;
+
+template <class T>
+vector<bool> Data<T>::constantNodes;
+
+template <class T>
+bool Data<T>::pruning = false;
+
+template <class T>
+long long unsigned Data<T>::pruned = 0;
+
+template <class T>
+vector<long long unsigned> Data<T>::outputs;
+
+template <class T>
+vector<unsigned> Data<T>::holders;
+
+template <class T>
+vector<unsigned> Data<T>::consumers;
+
+template <class T>
+vector<pair<long long unsigned,long long unsigned> > Data<T>::operandNodes;
+
+template <class T>
+vector<char> Data<T>::nodeState;
+
+template <class T>
+bool Data<T>::fmaCapture = false;
+
+template <class T>
+bool Data<T>::provenance = false;
+
+template <class T>
+unsigned Data<T>::location = 0;
+
+template <class T>
+const char *Data<T>::locationFile = NULL;
+
+template <class T>
+unsigned Data<T>::locationLine = 0;
+
+template <class T>
+vector<unsigned> Data<T>::nodeLocations;
+
+template <class T>
+long long unsigned Data<T>::fmas = 0;
+
+template <class T>
+bool Data<T>::reducing = false;
+
+template <class T>
+long long unsigned Data<T>::reduced = 0;
+
+template <class T>
+vector<long long unsigned> Data<T>::consumerNode;
+
+template <class T>
+unordered_map<long long unsigned,vector<long long unsigned> > Data<T>::naryOperands;
+
+template <class T>
+unordered_map<long long unsigned,pair<long long unsigned,long long unsigned> > Data<T>::reduceShapes;
+
+template <class T>
+unordered_map<long long unsigned,vector<long long unsigned> > Data<T>::reduceLevels;
+
+template <class T>
+unordered_map<long long unsigned,long long unsigned> Data<T>::reduceMemories;
+
 #endif
 
@@ -421,12 +421,25 @@ public:
 		myfile.close();
 	}
 
+	//bytes produced by each op, for HEFTMapper::nodeBytes
+	static vector<long long unsigned>& getNodeBytes() {
+		return nodeBytes;
+	}
+
 private:
 	long long unsigned ID;
 	static long long unsigned count;
 	static SparseMatrix matrix;
 	static vector<vector<string> > inputData;
     static map<string,int> funcNames;
+	static vector<long long unsigned> nodeBytes;
+
+	//record the size of the value an op produces (used for transfer costs when mapping)
+	static void setBytes(long long unsigned node, long long unsigned bytes) {
+		if(nodeBytes.size() <= node)
+			nodeBytes.resize(node+1,0);
+		nodeBytes[node] += bytes;
+	}
 
 	void oneOperand(Data &d1) {
 
@@ -471,6 +484,7 @@ private:
 
 		//set memory accesses
 		matrix.setNew(tmpNode,tmpNode,Types::setMemType(mem));
+		setBytes(tmpNode,mat.row*mat.col*sizeof(double));
 		
 		inputData.push_back(vector<string>());
 		if(d1.name.length() == 0) {
@@ -537,6 +551,7 @@ private:
 
 		//set memory accesses
 		matrix.setNew(oth.node,oth.node,Types::setMemType(mem));
+		setBytes(oth.node,oth.mat.row*oth.mat.col*sizeof(double));
 		
 		//add names to inputData
 		inputData.push_back(vector<string>());
@@ -615,6 +630,8 @@ private:
             
             //set the op node number
             outputs->ptr[i].node = tmpNode;
+
+            setBytes(tmpNode,outputs->ptr[i].mat.row*outputs->ptr[i].mat.col*sizeof(double));
         }
         
 		//cout << "Created node: " << node << endl;
@@ -631,5 +648,7 @@ bool Data::debug = false;
 
 map<string,int> Data::funcNames = create_map();
 
+vector<long long unsigned> Data::nodeBytes;
+
 #endif
 
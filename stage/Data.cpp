@@ -26,3 +26,5 @@ long long unsigned maxNodes = 0;
 long long unsigned currentNodes = 0;
 bool maxOverflow = false;
 bool currentOverflow = false;
+long long unsigned maxBytes = 0;
+long long unsigned currentBytes = 0;
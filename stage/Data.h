@@ -26,7 +26,12 @@
 #include <vector>
 #include <map>
 
+#include <stdio.h>
+
 #include "Graph.h"
+#include "MemoryModel.h"
+#include "TraceScope.h"
+#include "TraceRegion.h"
 
 using namespace std;
 
@@ -37,6 +42,8 @@ extern long long unsigned maxNodes;
 extern long long unsigned currentNodes;
 extern bool maxOverflow;
 extern bool currentOverflow;
+extern long long unsigned maxBytes;
+extern long long unsigned currentBytes;
 
 template <class T>
 class Data {
@@ -44,61 +51,59 @@ public:
 	bool calculated;
 	bool read;
 	long long unsigned node;
+	long long unsigned addr;
+	long long unsigned born;
+	//id of the op that computed the value
+	long long unsigned opId;
 	static bool debug;
 
 	Data() {
 		calculated = false;
 		read = false;
 		node = 0;
+		opId = 0;
+		addr = memAddress;
+		memAddress += sizeof(T);
 
 		value = new T;
 
 		//increment global node counters
-		if(!currentOverflow)
-			currentNodes++;
-
-		if(!maxOverflow && currentNodes > maxNodes)
-			maxNodes = currentNodes;
+		addLive();
 	}
 
 	Data(T val) {
 		calculated = false;
 		read = true;
 		node = 0;
+		opId = 0;
+		addr = 0;
 
 		value = new T;
 		*value = val;
 
 		//increment global node counters
-		if(!currentOverflow)
-			currentNodes++;
-
-		if(!maxOverflow && currentNodes > maxNodes)
-			maxNodes = currentNodes;
+		addLive();
 	}
 
 	Data(const Data &oth) {
 		calculated = oth.calculated;
 		read = oth.read;
 		node = oth.node;
+		opId = oth.opId;
+		addr = oth.addr;
 
 		value = new T;
 		*value = *(oth.value);
 
 		//increment global node counters
-		if(!currentOverflow)
-			currentNodes++;
-
-		if(!maxOverflow && currentNodes > maxNodes)
-			maxNodes = currentNodes;
+		addLive();
 	}
 
 	~Data() {
 		delete(value);
 
 		//decrement global node counters
-		if(!currentOverflow)
-			currentNodes--;
+		removeLive();
 	}
 
 	Data operator-() {
@@ -113,10 +118,11 @@ public:
 
 		read = d1.read;
 		calculated = d1.calculated;
+		addr = d1.addr;
 
 		node = d1.node;
+		opId = d1.opId;
 
-		value = new T;
 		*value = *(d1.value);
 
 		return *this;
@@ -126,10 +132,11 @@ public:
 
 		read = d1.read;
 		calculated = d1.calculated;
+		addr = d1.addr;
 
 		node = d1.node;
+		opId = d1.opId;
 
-		value = new T;
 		*value = *(d1.value);
 
 		return *this;
@@ -139,7 +146,7 @@ public:
 		Data oth(*this);
 		oth.calculated = true;
 
-		twoOperand(oth,d1);
+		twoOperand(oth,d1,Types::Add);
 
 		*oth.value = *(value) + *(d1.value);
 
@@ -151,7 +158,7 @@ public:
 	 */
 	Data& operator+=(Data d1) {
 		calculated = true;
-		oneOperand(d1);
+		oneOperand(d1,Types::Add);
 
 		*value += *(d1.value);
 
@@ -164,7 +171,7 @@ public:
 	Data& operator+=(Data &d1) {
 		calculated = true;
 
-		oneOperand(d1);
+		oneOperand(d1,Types::Add);
 
 		*value += *(d1.value);
 
@@ -175,7 +182,7 @@ public:
 		Data oth(*this);
 		oth.calculated = true;
 
-		twoOperand(oth,d1);
+		twoOperand(oth,d1,Types::Sub);
 
 		*oth.value = *(value) - *(d1.value);
 
@@ -185,7 +192,7 @@ public:
 	Data& operator-=(const Data &d1) {
 		calculated = true;
 
-		oneOperand(d1);
+		oneOperand(d1,Types::Sub);
 
 		*value -= *(d1.value);
 
@@ -196,7 +203,7 @@ public:
 		Data oth(*this);
 		oth.calculated = true;
 
-		twoOperand(oth,d1);
+		twoOperand(oth,d1,Types::Mult);
 
 		*oth.value = *(value) * *(d1.value);
 
@@ -206,7 +213,7 @@ public:
 	Data& operator*=(const Data &d1) {
 		calculated = true;
 
-		oneOperand(d1);
+		oneOperand(d1,Types::Mult);
 
 		*value *= *(d1.value);
 
@@ -217,7 +224,7 @@ public:
 		Data oth(*this);
 		oth.calculated = true;
 
-		twoOperand(oth,d1);
+		twoOperand(oth,d1,Types::Div);
 
 		if(*d1.value != 0)
 			*(oth.value) = *(value) / *(d1.value);
@@ -228,7 +235,7 @@ public:
 	Data& operator/=(const Data &d1) {
 		calculated = true;
 
-		oneOperand(d1);
+		oneOperand(d1,Types::Div);
 
 		*value /= *(d1.value);
 
@@ -239,7 +246,7 @@ public:
 		Data oth(*this);
 		oth.calculated = true;
 
-		twoOperand(oth,d1);
+		twoOperand(oth,d1,Types::Mod);
 
 		*oth.value = *(value) % *(d1.value);
 
@@ -249,7 +256,7 @@ public:
 	Data& operator%=(const Data &d1) {
 		calculated = true;
 
-		oneOperand(d1);
+		oneOperand(d1,Types::Mod);
 
 		*value %= *(d1.value);
 
@@ -287,12 +294,169 @@ public:
 		return ss.str();
 	}
 
+	/*
+	 * Limits the stage statistics to the most recent size levels so that
+	 * memory use stays constant for arbitrarily long traces. Levels that
+	 * fall out of the window are summarized into aggregate totals and a
+	 * histogram of stage widths, and are also appended to spillFile (one
+	 * line per level: level, ops, memory accesses, ops per type) if given.
+	 * Must be called before any operations are traced, a size of 0 returns
+	 * to the default unbounded mode. Not combined with setSampling, a
+	 * window is rejected while sampling is on.
+	 */
+	static void setWindow(long long unsigned size, string spillFile = "") {
+		if(size > 0 && samplePeriod > 1) {
+			printf("Unable to set a window while sampling, call setSampling(0) first\n");
+			return;
+		}
+
+		windowSize = size;
+		windowBase = 0;
+		levelCount = 0;
+		evictedLevels = 0;
+		evictedOps = 0;
+		evictedMem = 0;
+		lateOps = 0;
+		lateMem = 0;
+		widthHistogram.assign(65,0);
+
+		opStages.assign(size,0);
+		memStages.assign(size,0);
+		typeStages.assign(size*typeIds.size(),0);
+
+		if(spill != NULL) {
+			fclose(spill);
+			spill = NULL;
+		}
+		if(size > 0 && spillFile != "") {
+			spill = fopen(spillFile.c_str(),"w");
+			if(spill == NULL)
+				printf("Unable to open %s for writing\n",spillFile.c_str());
+		}
+	}
+
+	/*
+	 * Evicts all levels still in the window so that the aggregates (and
+	 * spill file) cover the whole trace
+	 */
+	static void flushWindow() {
+		if(windowSize == 0)
+			return;
+
+		while(windowBase < levelCount)
+			evictLevel();
+
+		if(spill != NULL)
+			fflush(spill);
+	}
+
+	/*
+	 * Turns on sampled tracing for long runs: of the units started by
+	 * sampleUnit() (for example the iterations of an outer loop) only the
+	 * first of every period is recorded into the stage statistics, the
+	 * rest are fast forwarded. Their ops still get their levels, so the
+	 * depth and the op and memory access totals stay exact, but they are
+	 * not added to any stage. writeSampledStages() extrapolates the stage
+	 * profile of the skipped units from the last recorded one. A period
+	 * of 0 or 1 records everything. Not combined with setWindow, sampling
+	 * is rejected while a window is set.
+	 */
+	static void setSampling(unsigned period) {
+		if(period > 1 && windowSize > 0) {
+			printf("Unable to sample with a window set, call setWindow(0) first\n");
+			return;
+		}
+
+		closeUnit();
+		samplePeriod = period;
+		sampleUnits = 0;
+		skippedUnits = 0;
+		skippedOps = 0;
+		skippedMem = 0;
+		sampledLevels = 0;
+		shapeLevels = 0;
+		shapeLevel.clear();
+		shapeOps.clear();
+		shapeMem.clear();
+		estimatedOps.clear();
+		estimatedMem.clear();
+		skippedCover.clear();
+	}
+
+	/*
+	 * Ends the current sampling unit and starts the next one
+	 */
+	static void sampleUnit() {
+		closeUnit();
+		if(samplePeriod <= 1)
+			return;
+
+		//a unit is recorded if it is due or there is no shape to extrapolate from yet
+		if(sampleUnits % samplePeriod == 0 || shapeOps.empty())
+			unitState = RecordedUnit;
+		else
+			unitState = SkippedUnit;
+		sampleUnits++;
+		unitOps = 0;
+		unitMem = 0;
+	}
+
+	/*
+	 * Writes one "ops estimate upper mem estimate" line per stage of a
+	 * sampled trace: the ops recorded in the stage, the estimate including
+	 * the skipped units, an upper bound (the recorded ops plus all ops of
+	 * the skipped units whose levels span the stage) and the same recorded
+	 * and estimated numbers for memory accesses. The recorded ops are a
+	 * lower bound. The number of lines is the exact depth.
+	 */
+	static void writeSampledStages(string filename) {
+		closeUnit();
+
+		FILE *fp = fopen(filename.c_str(),"w");
+		if(fp == NULL) {
+			printf("Unable to open %s for writing\n",filename.c_str());
+			return;
+		}
+
+		long long unsigned levels = sampledLevels;
+		if(levels < opStages.size())
+			levels = opStages.size();
+
+		long long int cover = 0;
+		for(long long unsigned i=0; i<levels; i++) {
+			long long unsigned ops = (i < opStages.size()) ? opStages[i] : 0;
+			long long unsigned mem = (i < memStages.size()) ? memStages[i] : 0;
+			double estOps = ops + ((i < estimatedOps.size()) ? estimatedOps[i] : 0);
+			double estMem = mem + ((i < estimatedMem.size()) ? estimatedMem[i] : 0);
+			if(i < skippedCover.size())
+				cover += skippedCover[i];
+
+			fprintf(fp,"%llu %.2f %llu %llu %.2f\n",ops,estOps,ops+cover,mem,estMem);
+		}
+		fclose(fp);
+	}
+
+	static void printSampling() {
+		closeUnit();
+
+		long long unsigned levels = sampledLevels;
+		if(levels < opStages.size())
+			levels = opStages.size();
+
+		cout << "Sampled Units: " << sampleUnits - skippedUnits << " of " << sampleUnits << endl;
+		cout << "Skipped Ops: " << skippedOps << endl;
+		cout << "Skipped Mem: " << skippedMem << endl;
+		cout << "Depth: " << levels << endl;
+	}
+
 	static void writeOpStages(string filename) {
 		ofstream myfile;
 		myfile.open (filename.c_str());
 
-		for(unsigned i=0; i<opStages.size(); i++) {
-			myfile << opStages[i] << "\n";
+		for(long long unsigned i=firstLevel(); i<lastLevel(); i++) {
+			if(windowSize > 0)
+				myfile << i << " ";
+			myfile << opStages[stageSlot(i)] << "\n";
 		}
 		myfile.close();
 	}
@@ -301,8 +465,92 @@ public:
 		ofstream myfile;
 		myfile.open (filename.c_str());
 
-		for(unsigned i=0; i<memStages.size(); i++) {
-			myfile << memStages[i] << "\n";
+		for(long long unsigned i=firstLevel(); i<lastLevel(); i++) {
+			if(windowSize > 0)
+				myfile << i << " ";
+			myfile << memStages[stageSlot(i)] << "\n";
+		}
+		myfile.close();
+	}
+
+	/*
+	 * Writes the level x op type table as CSV, one row per stage with
+	 * one column per op type that occurred
+	 */
+	static void writeTypeStages(string filename) {
+		ofstream myfile;
+		myfile.open (filename.c_str());
+
+		unsigned cols = typeIds.size();
+		myfile << "stage";
+		for(unsigned j=0; j<cols; j++) {
+			myfile << "," << Types::getName(typeIds[j]);
+			if(typeIds[j] > Types::user)
+				myfile << typeIds[j] - Types::user;
+		}
+		myfile << "\n";
+
+		for(long long unsigned i=firstLevel(); cols > 0 && i<lastLevel(); i++) {
+			myfile << i;
+			for(unsigned j=0; j<cols; j++) {
+				unsigned long long pos = stageSlot(i)*cols+j;
+				myfile << "," << (pos < typeStages.size() ? typeStages[pos] : 0);
+			}
+			myfile << "\n";
+		}
+		myfile.close();
+	}
+
+	/*
+	 * Writes the level x op type table in binary: the first stage, number
+	 * of stages and number of columns (8 bytes each), the op type of each
+	 * column (4 bytes each) and then the row-major table of counts
+	 * (8 bytes each)
+	 */
+	static void writeTypeStagesBinary(string filename) {
+		FILE *fp = fopen(filename.c_str(),"wb");
+		if(fp == NULL) {
+			printf("Unable to open %s for writing\n",filename.c_str());
+			return;
+		}
+
+		long long unsigned cols = typeIds.size();
+		long long unsigned first = firstLevel();
+		long long unsigned levels = lastLevel() - first;
+		//pad out trailing stages that never had a node added
+		if(typeStages.size() < opStages.size()*cols)
+			typeStages.resize(opStages.size()*cols,0);
+
+		fwrite(&first,sizeof(first),1,fp);
+		fwrite(&levels,sizeof(levels),1,fp);
+		fwrite(&cols,sizeof(cols),1,fp);
+		if(cols > 0) {
+			fwrite(&typeIds[0],sizeof(int),cols,fp);
+			for(long long unsigned i=first; i<first+levels; i++)
+				fwrite(&typeStages[stageSlot(i)*cols],sizeof(long long unsigned),cols,fp);
+		}
+		fclose(fp);
+	}
+
+	/*
+	 * Writes the aggregate summary of the levels evicted from the window
+	 * followed by the histogram of their widths (bucket b holds the levels
+	 * with 2^(b-1) <= ops < 2^b)
+	 */
+	static void writeWindowSummary(string filename) {
+		ofstream myfile;
+		myfile.open (filename.c_str());
+
+		myfile << "window " << windowSize << "\n";
+		myfile << "levels " << levelCount << "\n";
+		myfile << "evictedLevels " << evictedLevels << "\n";
+		myfile << "evictedOps " << evictedOps << "\n";
+		myfile << "evictedMem " << evictedMem << "\n";
+		myfile << "lateOps " << lateOps << "\n";
+		myfile << "lateMem " << lateMem << "\n";
+		for(unsigned i=0; i<widthHistogram.size(); i++) {
+			if(widthHistogram[i] > 0)
+				myfile << "width " << i << " " << widthHistogram[i] << "\n";
 		}
 		myfile.close();
 	}
@@ -310,27 +558,59 @@ public:
 	static void writeResult(string filename) {
 	  string op = filename + "_op.txt";
 	  string mem = filename + "_mem.txt";
+	  string type = filename + "_type.csv";
 	  writeOpStages(op);
 	  writeMemStages(mem);
+	  writeTypeStages(type);
+	  if(windowSize > 0)
+	    writeWindowSummary(filename + "_window.txt");
+	  writeSpans(filename + "_span.txt");
+	  writeLiveStages(filename + "_live.txt");
+	  writeLifetimes(filename + "_lifetime.txt");
 	}
 
 	static void printOpStages() {
 		printf("OpStages:\n");
-		for(unsigned i=0; i<opStages.size(); i++) {
-			printf("Stage(%u) = %llu\n",i,opStages[i]);
+		for(long long unsigned i=firstLevel(); i<lastLevel(); i++) {
+			printf("Stage(%llu) = %llu\n",i,opStages[stageSlot(i)]);
 		}
 	}
 
 	static void printMemStages() {
 		printf("MemStages:\n");
-		for(unsigned i=0; i<memStages.size(); i++) {
-			printf("Stage(%u) = %llu\n",i,memStages[i]);
+		for(long long unsigned i=firstLevel(); i<lastLevel(); i++) {
+			printf("Stage(%llu) = %llu\n",i,memStages[stageSlot(i)]);
 		}
 	}
 
+	static void printTypeStages() {
+		printf("TypeStages:\n");
+		unsigned cols = typeIds.size();
+		for(long long unsigned i=firstLevel(); i<lastLevel(); i++) {
+			printf("Stage(%llu) =",i);
+			for(unsigned j=0; j<cols; j++) {
+				unsigned long long pos = stageSlot(i)*cols+j;
+				printf(" %s",Types::getName(typeIds[j]));
+				if(typeIds[j] > Types::user)
+					printf("%d",typeIds[j] - Types::user);
+				printf(":%llu",(pos < typeStages.size() ? typeStages[pos] : 0));
+			}
+			printf("\n");
+		}
+	}
+
+	static void printWindowSummary() {
+		printf("Window: %llu levels (%llu..%llu of %llu)\n",windowSize,firstLevel(),lastLevel(),levelCount);
+		printf("Evicted: %llu levels, %llu ops, %llu mem\n",evictedLevels,evictedOps,evictedMem);
+		printf("Late: %llu ops, %llu mem\n",lateOps,lateMem);
+	}
+
 	static void printResult() {
 	  printOpStages();
 	  printMemStages();
+	  printTypeStages();
+	  if(windowSize > 0)
+	    printWindowSummary();
 	}
 
 	static void printStats() {
@@ -343,6 +623,101 @@ public:
 			cout << "Max Nodes: OVERFLOW!" << endl;
 		else
 			cout << "Max Nodes: " << maxNodes << endl;
+
+		cout << "Current Bytes: " << currentBytes << endl;
+		cout << "Max Bytes: " << maxBytes << endl;
+	}
+
+	/*
+	 * Writes the histogram of edge spans (consumer stage - producer stage),
+	 * one "span count" line per span that occurred, followed by the
+	 * maximum span into each op type that occurred, in op type order (0 for
+	 * a type whose ops only read memory). With a window the line for the
+	 * window size counts all spans of at least that many stages.
+	 */
+	static void writeSpans(string filename) {
+		ofstream myfile;
+		myfile.open (filename.c_str());
+
+		for(long long unsigned i=0; i<spanHistogram.size(); i++) {
+			if(spanHistogram[i] > 0)
+				myfile << i << " " << spanHistogram[i] << "\n";
+		}
+
+		//columns are in the order the types were first seen
+		map<int,long long unsigned> byType;
+		for(unsigned j=0; j<typeIds.size(); j++)
+			byType[typeIds[j]] = (j < spanMax.size()) ? spanMax[j] : 0;
+
+		map<int,long long unsigned>::iterator it;
+		for(it=byType.begin(); it!=byType.end(); ++it) {
+			myfile << "max " << Types::getName(it->first);
+			if(it->first > Types::user)
+				myfile << it->first - Types::user;
+			myfile << " " << it->second << "\n";
+		}
+		myfile.close();
+	}
+
+	/*
+	 * Sets how many ops are grouped into each sample of the live value
+	 * profile over the trace (the maximum over the group is kept)
+	 */
+	static void setLiveInterval(long long unsigned interval) {
+		liveInterval = (interval > 0) ? interval : 1;
+	}
+
+	/*
+	 * Writes the maximum number of live values and live bytes seen while
+	 * ops were added to each stage, one stage per line
+	 */
+	static void writeLiveStages(string filename) {
+		ofstream myfile;
+		myfile.open (filename.c_str());
+
+		for(long long unsigned i=firstLevel(); i<lastLevel(); i++) {
+			long long unsigned slot = stageSlot(i);
+			if(slot < liveStages.size())
+				myfile << i << " " << liveStages[slot] << " " << liveByteStages[slot] << "\n";
+			else
+				myfile << i << " 0 0\n";
+		}
+		myfile.close();
+	}
+
+	/*
+	 * Writes the live value profile over the trace, one line per interval
+	 * of ops: the first op in the interval, the max live values and the
+	 * max live bytes during it
+	 */
+	static void writeLiveProfile(string filename) {
+		ofstream myfile;
+		myfile.open (filename.c_str());
+
+		for(long long unsigned i=0; i<liveProfile.size(); i++) {
+			myfile << i*liveInterval << " " << liveProfile[i] << " " << liveByteProfile[i] << "\n";
+		}
+
+		//the last interval may not be full yet
+		if(opCount % liveInterval != 0)
+			myfile << liveProfile.size()*liveInterval << " " << intervalMax << " " << intervalMaxBytes << "\n";
+		myfile.close();
+	}
+
+	/*
+	 * Writes the histogram of value lifetimes (in ops traced between the
+	 * creation and destruction of a value), bucket b holds the values with
+	 * 2^(b-1) <= lifetime < 2^b
+	 */
+	static void writeLifetimes(string filename) {
+		ofstream myfile;
+		myfile.open (filename.c_str());
+
+		for(unsigned i=0; i<lifetimeHistogram.size(); i++) {
+			if(lifetimeHistogram[i] > 0)
+				myfile << i << " " << lifetimeHistogram[i] << "\n";
+		}
+		myfile.close();
 	}
 
 private:
@@ -350,7 +725,425 @@ private:
 	static long long unsigned count;
 	static vector<long long unsigned> opStages;
 	static vector<long long unsigned> memStages;
-	void oneOperand(Data &d1) {
+	static vector<long long unsigned> typeStages;
+	static vector<int> typeColumns;
+	static vector<int> typeIds;
+
+	/*
+	 * Returns the column in the typeStages table for the given op type,
+	 * adding a new column (and restriding the table) the first time an op
+	 * type is seen so that the table only has columns for ops that occur
+	 */
+	static unsigned typeColumn(int op) {
+		if(op >= 0 && (unsigned)op < typeColumns.size() && typeColumns[op] >= 0)
+			return typeColumns[op];
+
+		while(typeColumns.size() <= (unsigned)op){typeColumns.push_back(-1);}
+
+		unsigned oldCols = typeIds.size();
+		typeColumns[op] = oldCols;
+		typeIds.push_back(op);
+
+		//restride existing rows to make room for the new column
+		if(oldCols > 0 && typeStages.size() > 0) {
+			unsigned long long levels = typeStages.size() / oldCols;
+			vector<long long unsigned> tmp(levels * (oldCols+1),0);
+			for(unsigned long long i=0; i<levels; i++) {
+				for(unsigned j=0; j<oldCols; j++) {
+					tmp[i*(oldCols+1)+j] = typeStages[i*oldCols+j];
+				}
+			}
+			typeStages.swap(tmp);
+		}
+
+		return oldCols;
+	}
+
+	//window (ring buffer) mode state, windowSize of 0 is unbounded
+	static long long unsigned windowSize;
+	static long long unsigned windowBase;
+	static long long unsigned levelCount;
+	static long long unsigned evictedLevels;
+	static long long unsigned evictedOps;
+	static long long unsigned evictedMem;
+	static long long unsigned lateOps;
+	static long long unsigned lateMem;
+	static vector<long long unsigned> widthHistogram;
+	static FILE *spill;
+
+	//edge span state
+	static vector<long long unsigned> spanHistogram;
+	static vector<long long unsigned> spanMax;
+
+	/*
+	 * Records an edge that spans the given number of stages between its
+	 * producer and a consumer of the given op type. With a window the
+	 * histogram stops at the window size so its memory stays bounded too,
+	 * longer spans are counted in that last bucket.
+	 */
+	static void addSpan(long long unsigned span, int op) {
+		long long unsigned bucket = span;
+		if(windowSize > 0 && bucket > windowSize)
+			bucket = windowSize;
+
+		if(spanHistogram.size() <= bucket)
+			spanHistogram.resize(bucket+1,0);
+		spanHistogram[bucket]++;
+
+		unsigned col = typeColumn(op);
+		if(spanMax.size() <= col)
+			spanMax.resize(col+1,0);
+		if(span > spanMax[col])
+			spanMax[col] = span;
+	}
+
+	//live value profile state
+	static vector<long long unsigned> liveStages;
+	static vector<long long unsigned> liveByteStages;
+	static vector<long long unsigned> liveProfile;
+	static vector<long long unsigned> liveByteProfile;
+	static vector<long long unsigned> lifetimeHistogram;
+	static long long unsigned liveInterval;
+	static long long unsigned intervalMax;
+	static long long unsigned intervalMaxBytes;
+
+	//sampled tracing, see setSampling
+	enum UnitState { NoUnit, RecordedUnit, SkippedUnit };
+	static unsigned samplePeriod;
+	static long long unsigned sampleUnits;
+	static long long unsigned skippedUnits;
+	static long long unsigned skippedOps;
+	static long long unsigned skippedMem;
+	static long long unsigned sampledLevels;
+	static UnitState unitState;
+	//levels spanned and totals of the current unit
+	static long long unsigned unitFirst;
+	static long long unsigned unitLast;
+	static long long unsigned unitOps;
+	static long long unsigned unitMem;
+	//ops and memory accesses per level of the current recorded unit
+	static map<long long unsigned,pair<long long unsigned,long long unsigned> > unitLevels;
+	//levels spanned by the last recorded unit and the fraction of its ops
+	//and memory accesses in each level that had any, relative to its first
+	static long long unsigned shapeLevels;
+	static vector<long long unsigned> shapeLevel;
+	static vector<double> shapeOps;
+	static vector<double> shapeMem;
+	//extrapolated ops and memory accesses of the skipped units per stage
+	static vector<double> estimatedOps;
+	static vector<double> estimatedMem;
+	//difference array of the ops of the skipped units spanning each stage
+	static vector<long long int> skippedCover;
+
+	/*
+	 * Spreads total over the levels first to first+levels-1 of estimate in
+	 * the shape of the last recorded unit, stretched or squeezed so each
+	 * level of the shape lands proportionally on the levels it overlaps
+	 */
+	static void spread(vector<double> &shape, double total, long long unsigned first, long long unsigned levels, vector<double> &estimate) {
+		double scale = (double)levels / shapeLevels;
+
+		for(long long unsigned k=0; k<shape.size(); k++) {
+			double lo = shapeLevel[k]*scale;
+			double hi = (shapeLevel[k]+1 == shapeLevels) ? levels : (shapeLevel[k]+1)*scale;
+			for(long long unsigned t=(long long unsigned)lo; t<levels && t<hi; t++) {
+				double overlap = ((hi < t+1) ? hi : t+1) - ((lo > t) ? lo : t);
+				estimate[first+t] += shape[k] * total * overlap / (hi - lo);
+			}
+		}
+	}
+
+	/*
+	 * Finishes the current sampling unit: a recorded unit becomes the shape
+	 * to extrapolate from, a skipped unit is extrapolated with it
+	 */
+	static void closeUnit() {
+		if(unitState == RecordedUnit && unitOps > 0) {
+			long long unsigned first = unitLevels.begin()->first;
+			shapeLevels = unitLevels.rbegin()->first - first + 1;
+			shapeLevel.clear();
+			shapeOps.clear();
+			shapeMem.clear();
+
+			map<long long unsigned,pair<long long unsigned,long long unsigned> >::iterator it;
+			for(it=unitLevels.begin(); it!=unitLevels.end(); ++it) {
+				shapeLevel.push_back(it->first-first);
+				shapeOps.push_back((double)it->second.first / unitOps);
+				//without memory accesses to go by follow the ops
+				if(unitMem > 0)
+					shapeMem.push_back((double)it->second.second / unitMem);
+				else
+					shapeMem.push_back(shapeOps.back());
+			}
+		}
+		else if(unitState == SkippedUnit) {
+			skippedUnits++;
+			if(unitOps > 0) {
+				long long unsigned levels = unitLast - unitFirst + 1;
+				if(estimatedOps.size() <= unitLast) {
+					estimatedOps.resize(unitLast+1,0);
+					estimatedMem.resize(unitLast+1,0);
+				}
+				spread(shapeOps,unitOps,unitFirst,levels,estimatedOps);
+				spread(shapeMem,unitMem,unitFirst,levels,estimatedMem);
+
+				if(skippedCover.size() <= unitLast+1)
+					skippedCover.resize(unitLast+2,0);
+				skippedCover[unitFirst] += unitOps;
+				skippedCover[unitLast+1] -= unitOps;
+			}
+		}
+
+		unitLevels.clear();
+		unitState = NoUnit;
+	}
+
+	/*
+	 * Counts an op of the current unit, returns true if the unit is skipped
+	 * and the op must not be added to the stages
+	 */
+	static bool sampleOp(long long unsigned index, int mem) {
+		if(index >= sampledLevels)
+			sampledLevels = index+1;
+
+		if(unitState == NoUnit)
+			return false;
+
+		if(unitOps == 0 || index < unitFirst)
+			unitFirst = index;
+		if(unitOps == 0 || index > unitLast)
+			unitLast = index;
+		unitOps++;
+		unitMem += mem;
+
+		if(unitState == RecordedUnit) {
+			pair<long long unsigned,long long unsigned> &level = unitLevels[index];
+			level.first++;
+			level.second += mem;
+			return false;
+		}
+
+		skippedOps++;
+		skippedMem += mem;
+		return true;
+	}
+
+	/*
+	 * Counts a newly created value as live
+	 */
+	void addLive() {
+		born = opCount;
+
+		if(!currentOverflow) {
+			if(currentNodes + 1 == 0)
+				currentOverflow = true;
+			else {
+				currentNodes++;
+				currentBytes += sizeof(T);
+			}
+		}
+
+		if(!maxOverflow) {
+			if(currentOverflow)
+				maxOverflow = true;
+			else if(currentNodes > maxNodes)
+				maxNodes = currentNodes;
+		}
+
+		if(currentBytes > maxBytes)
+			maxBytes = currentBytes;
+
+		if(currentNodes > intervalMax)
+			intervalMax = currentNodes;
+
+		if(currentBytes > intervalMaxBytes)
+			intervalMaxBytes = currentBytes;
+	}
+
+	/*
+	 * Removes a destroyed value from the live count and records its lifetime
+	 */
+	void removeLive() {
+		if(!currentOverflow) {
+			currentNodes--;
+			currentBytes -= sizeof(T);
+		}
+
+		long long unsigned lifetime = opCount - born;
+		unsigned bucket = 0;
+		while(bucket < 64 && (lifetime >> bucket) > 0){bucket++;}
+
+		if(lifetimeHistogram.size() <= bucket)
+			lifetimeHistogram.resize(bucket+1,0);
+		lifetimeHistogram[bucket]++;
+	}
+
+	/*
+	 * Records the live values at the time an op is added to the given
+	 * stage slot
+	 */
+	static void addLiveStage(long long unsigned slot) {
+		if(liveStages.size() <= slot) {
+			liveStages.resize(slot+1,0);
+			liveByteStages.resize(slot+1,0);
+		}
+
+		if(currentNodes > liveStages[slot])
+			liveStages[slot] = currentNodes;
+
+		if(currentBytes > liveByteStages[slot])
+			liveByteStages[slot] = currentBytes;
+
+	}
+
+	static long long unsigned firstLevel() {
+		return (windowSize > 0) ? windowBase : 0;
+	}
+
+	static long long unsigned lastLevel() {
+		return (windowSize > 0) ? levelCount : opStages.size();
+	}
+
+	static long long unsigned stageSlot(long long unsigned index) {
+		return (windowSize > 0) ? index % windowSize : index;
+	}
+
+	/*
+	 * Folds the oldest level in the window into the aggregates (and spill
+	 * file) and clears its slot for reuse
+	 */
+	static void evictLevel() {
+		long long unsigned slot = stageSlot(windowBase);
+		unsigned cols = typeIds.size();
+		long long unsigned width = opStages[slot];
+
+		if(spill != NULL) {
+			fprintf(spill,"%llu %llu %llu",windowBase,width,memStages[slot]);
+			for(unsigned j=0; j<cols; j++) {
+				fprintf(spill," %llu",typeStages[slot*cols+j]);
+			}
+			fprintf(spill,"\n");
+		}
+
+		unsigned bucket = 0;
+		while(bucket < 64 && (width >> bucket) > 0){bucket++;}
+		widthHistogram[bucket]++;
+
+		evictedLevels++;
+		evictedOps += width;
+		evictedMem += memStages[slot];
+
+		opStages[slot] = 0;
+		memStages[slot] = 0;
+		if(slot < liveStages.size()) {
+			liveStages[slot] = 0;
+			liveByteStages[slot] = 0;
+		}
+		for(unsigned j=0; j<cols; j++) {
+			typeStages[slot*cols+j] = 0;
+		}
+
+		windowBase++;
+	}
+
+	/*
+	 * Adds a node of the given op type to the given stage along with the
+	 * number of memory accesses it performed and the ids of the ops that
+	 * computed its operands
+	 */
+	static void addStage(long long unsigned index, int mem, int op, long long unsigned *preds, unsigned numPreds) {
+		//advance the trace time, closing out the current interval of the
+		//live value profile when it is full
+		if(++opCount % liveInterval == 0) {
+			liveProfile.push_back(intervalMax);
+			liveByteProfile.push_back(intervalMaxBytes);
+			intervalMax = currentNodes;
+			intervalMaxBytes = currentBytes;
+		}
+
+		//attribute the op to the active profiling scopes
+		if(TraceScope::active())
+			TraceScope::addOp(mem,preds,numPreds);
+
+		//fast forward through skipped sampling units
+		if(unitState != NoUnit && sampleOp(index,mem))
+			return;
+
+		if(windowSize > 0) {
+			//level has already left the window, only count it
+			if(index < windowBase) {
+				lateOps++;
+				lateMem += mem;
+				return;
+			}
+
+			//slide the window forward to make room for the new level
+			while(index >= windowBase + windowSize){evictLevel();}
+
+			if(levelCount <= index)
+				levelCount = index+1;
+		}
+		else {
+			//make sure we're not adding to a new stage
+			while(opStages.size() <= index){opStages.push_back(0);}
+
+			//make sure we're not adding to a new stage
+			while(memStages.size() <= index){memStages.push_back(0);}
+		}
+
+		long long unsigned slot = stageSlot(index);
+
+		//add the node to the stage
+		opStages[slot]++;
+
+		//set memory accesses
+		memStages[slot]+=mem;
+
+		//add the node to the level x op type table
+		unsigned col = typeColumn(op);
+		unsigned cols = typeIds.size();
+		if(typeStages.size() <= slot*cols+col)
+			typeStages.resize(((windowSize > 0) ? windowSize : slot+1)*cols,0);
+
+		typeStages[slot*cols+col]++;
+
+		//record the live values at this stage
+		addLiveStage(slot);
+	}
+
+	/*
+	 * Returns true if reading this variable costs a memory access. Constants
+	 * (addr 0) never do, otherwise the memory model decides, or without one
+	 * only the first read of the variable does.
+	 */
+	bool memoryAccess() {
+		if(memoryModel != NULL)
+			return addr != 0 && !memoryModel->access(addr);
+
+		if(read)
+			return false;
+
+		read = true;
+		return true;
+	}
+
+	/*
+	 * Makes this variable a fresh untraced value, for results computed
+	 * while recording is off: they enter the graph as memory reads
+	 */
+	void untrace() {
+		calculated = false;
+		read = false;
+		node = 0;
+		addr = memAddress;
+		memAddress += sizeof(T);
+	}
+
+	void oneOperand(Data &d1, int op) {
+		if(!recording) {
+			untrace();
+			return;
+		}
 
 		//initialize number of memory accesses
 		int mem = 0;
@@ -360,10 +1153,8 @@ private:
 
 		//check first operand
 		if(!calculated) {	//this variable has just been created (ie. memory access)
-			if(!read) {	//variable has not already been read into cache (ie. memory not already accessed)
+			if(memoryAccess()) {	//variable is not already in on-chip memory (ie. memory accessed)
 				mem++;
-
-				read = true;
 			}
 		}
 		else {	//this variable is the result of some other operation (ie. previous Op)
@@ -372,10 +1163,8 @@ private:
 
 		//check second operand
 		if(!d1.calculated) {	//this variable has just been created (ie. memory access)
-			if(!d1.read) {	//variable has not already been read into cache (ie. memory not already accessed)
+			if(d1.memoryAccess()) {	//variable is not already in on-chip memory (ie. memory accessed)
 				mem++;
-
-				d1.read = true;
 			}
 		}
 		else {	//this variable is the result of some other operation (ie. previous Op)
@@ -383,6 +1172,24 @@ private:
 				index = d1.node+1;
 		}
 
+		//record how many stages each operand travels to reach this node,
+		//skipped sampling units leave no stage statistics behind. An op
+		//using one value twice (x*x) has a single edge, as in a full graph
+		if(unitState != SkippedUnit) {
+			if(calculated)
+				addSpan(index-node,op);
+			if(d1.calculated && !(calculated && opId == d1.opId))
+				addSpan(index-d1.node,op);
+		}
+
+		//ops that computed the operands
+		long long unsigned preds[2];
+		unsigned numPreds = 0;
+		if(calculated)
+			preds[numPreds++] = opId;
+		if(d1.calculated)
+			preds[numPreds++] = d1.opId;
+
 		//set this variable as a calculated variable (ie. not a memory access, has dependencies)
 		calculated = true;
 
@@ -390,20 +1197,17 @@ private:
 		//store current nodes stage
 		node = index;
 
-		//make sure we're not adding to a new stage
-		while(opStages.size() <= index){opStages.push_back(0);}
-
-		//add the node to the stage
-		opStages[index]++;
-
-		//make sure we're not adding to a new stage
-		while(memStages.size() <= index){memStages.push_back(0);}
-
-		//set memory accesses
-		memStages[index]+=mem;
+		//add the node and its memory accesses to the stage
+		addStage(index,mem,op,preds,numPreds);
+		opId = opCount-1;
 	}
 
-	void twoOperand(Data &oth, Data &d1) {
+	void twoOperand(Data &oth, Data &d1, int op) {
+		if(!recording) {
+			oth.untrace();
+			return;
+		}
+
 		//set this variable as a calculated variable (ie. not a memory access, has dependencies)
 		oth.calculated = true;
 
@@ -415,10 +1219,8 @@ private:
 
 		//check first operand
 		if(!calculated) {	//this variable has just been created (ie. memory access)
-			if(!read) {	//variable has not already been read into cache (ie. memory not already accessed)
+			if(memoryAccess()) {	//variable is not already in on-chip memory (ie. memory accessed)
 				mem++;
-
-				read = true;
 			}
 		}
 		else {	//this variable is the result of some other operation (ie. previous Op)
@@ -427,10 +1229,8 @@ private:
 
 		//check second operand
 		if(!d1.calculated) {	//this variable has just been created (ie. memory access)
-			if(!d1.read) {	//variable has not already been read into cache (ie. memory not already accessed)
+			if(d1.memoryAccess()) {	//variable is not already in on-chip memory (ie. memory accessed)
 				mem++;
-
-				d1.read = true;
 			}
 		}
 		else {	//this variable is the result of some other operation (ie. previous Op)
@@ -438,21 +1238,31 @@ private:
 				index = d1.node+1;
 		}
 
+		//record how many stages each operand travels to reach this node,
+		//skipped sampling units leave no stage statistics behind. An op
+		//using one value twice (x*x) has a single edge, as in a full graph
+		if(unitState != SkippedUnit) {
+			if(calculated)
+				addSpan(index-node,op);
+			if(d1.calculated && !(calculated && opId == d1.opId))
+				addSpan(index-d1.node,op);
+		}
+
+		//ops that computed the operands
+		long long unsigned preds[2];
+		unsigned numPreds = 0;
+		if(calculated)
+			preds[numPreds++] = opId;
+		if(d1.calculated)
+			preds[numPreds++] = d1.opId;
+
 		//set op
 		//store current nodes stage
 		oth.node = index;
 
-		//make sure we're not adding to a new stage
-		while(opStages.size() <= index){opStages.push_back(0);}
-
-		//add the node to the stage
-		opStages[index]++;
-
-		//make sure we're not adding to a new stage
-		while(memStages.size() <= index){memStages.push_back(0);}
-
-		//set memory accesses
-		memStages[index]+=mem;
+		//add the node and its memory accesses to the stage
+		addStage(index,mem,op,preds,numPreds);
+		oth.opId = opCount-1;
 	}
 };
 
@@ -462,6 +1272,132 @@ vector<long long unsigned> Data<T>::opStages;
 template <class T>
 vector<long long unsigned> Data<T>::memStages;
 
+template <class T>
+vector<long long unsigned> Data<T>::typeStages;
+
+template <class T>
+vector<int> Data<T>::typeColumns;
+
+template <class T>
+vector<int> Data<T>::typeIds;
+
+template <class T>
+long long unsigned Data<T>::windowSize = 0;
+
+template <class T>
+long long unsigned Data<T>::windowBase = 0;
+
+template <class T>
+long long unsigned Data<T>::levelCount = 0;
+
+template <class T>
+long long unsigned Data<T>::evictedLevels = 0;
+
+template <class T>
+long long unsigned Data<T>::evictedOps = 0;
+
+template <class T>
+long long unsigned Data<T>::evictedMem = 0;
+
+template <class T>
+long long unsigned Data<T>::lateOps = 0;
+
+template <class T>
+long long unsigned Data<T>::lateMem = 0;
+
+template <class T>
+vector<long long unsigned> Data<T>::widthHistogram;
+
+template <class T>
+FILE *Data<T>::spill = NULL;
+
+template <class T>
+vector<long long unsigned> Data<T>::spanHistogram;
+
+template <class T>
+vector<long long unsigned> Data<T>::spanMax;
+
+template <class T>
+vector<long long unsigned> Data<T>::liveStages;
+
+template <class T>
+vector<long long unsigned> Data<T>::liveByteStages;
+
+template <class T>
+vector<long long unsigned> Data<T>::liveProfile;
+
+template <class T>
+vector<long long unsigned> Data<T>::liveByteProfile;
+
+template <class T>
+vector<long long unsigned> Data<T>::lifetimeHistogram;
+
+template <class T>
+long long unsigned Data<T>::liveInterval = 1024;
+
+template <class T>
+long long unsigned Data<T>::intervalMax = 0;
+
+template <class T>
+long long unsigned Data<T>::intervalMaxBytes = 0;
+
+template <class T>
+unsigned Data<T>::samplePeriod = 0;
+
+template <class T>
+long long unsigned Data<T>::sampleUnits = 0;
+
+template <class T>
+long long unsigned Data<T>::skippedUnits = 0;
+
+template <class T>
+long long unsigned Data<T>::skippedOps = 0;
+
+template <class T>
+long long unsigned Data<T>::skippedMem = 0;
+
+template <class T>
+long long unsigned Data<T>::sampledLevels = 0;
+
+template <class T>
+typename Data<T>::UnitState Data<T>::unitState = Data<T>::NoUnit;
+
+template <class T>
+long long unsigned Data<T>::unitFirst = 0;
+
+template <class T>
+long long unsigned Data<T>::unitLast = 0;
+
+template <class T>
+long long unsigned Data<T>::unitOps = 0;
+
+template <class T>
+long long unsigned Data<T>::unitMem = 0;
+
+template <class T>
+map<long long unsigned,pair<long long unsigned,long long unsigned> > Data<T>::unitLevels;
+
+template <class T>
+long long unsigned Data<T>::shapeLevels = 0;
+
+template <class T>
+vector<long long unsigned> Data<T>::shapeLevel;
+
+template <class T>
+vector<double> Data<T>::shapeOps;
+
+template <class T>
+vector<double> Data<T>::shapeMem;
+
+template <class T>
+vector<double> Data<T>::estimatedOps;
+
+template <class T>
+vector<double> Data<T>::estimatedMem;
+
+template <class T>
+vector<long long int> Data<T>::skippedCover;
+
 template <class T>
 bool Data<T>::debug = false;
 
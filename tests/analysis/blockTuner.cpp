@@ -0,0 +1,177 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * blockTuner.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks BlockTuner on small blocked dot products and matrix multiplies:
+ * the candidates are every divisor with the metrics of its generated
+ * graph (peak live values counted by brute force), the feasibility filter
+ * follows the memory budget and parallelism target, and the choice is the
+ * feasible candidate with the fewest memory accesses or, when none is
+ * feasible, the one with the fewest live values
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "CSRGraph.h"
+#include "KernelGraphs.h"
+#include "BlockTuner.h"
+#include "check.h"
+
+using namespace std;
+
+typedef long long unsigned ull;
+
+//values produced before node i that are still needed by it or a later node
+static ull bruteLive(CSRGraph &graph) {
+	ull peak = 0;
+	for(ull t=0; t<graph.nodes; t++) {
+		ull live = 0;
+		for(ull v=0; v<=t; v++) {
+			if(graph.outDegree(v) == 0)
+				continue;
+			if(graph.succ[graph.succOffset[v+1]-1] > t)
+				live++;
+		}
+		if(live > peak)
+			peak = live;
+	}
+	return peak;
+}
+
+static void checkCandidate(BlockTuner &tuner, BlockTuner::Candidate &c, CSRGraph &graph, string name) {
+	ull mem = 0;
+	for(ull i=0; i<graph.nodes; i++)
+		mem += graph.memType(i);
+	vector<ull> level = graph.levels();
+	ull depth = 0;
+	for(ull i=0; i<level.size(); i++)
+		if(level[i]+1 > depth)
+			depth = level[i]+1;
+	ull live = bruteLive(graph);
+
+	check(c.nodes == graph.nodes && c.memAccesses == mem && c.depth == depth && c.maxLive == live,"metrics " + name);
+	double parallelism = (double)graph.nodes / depth;
+	bool feasible = (tuner.memoryBudget == 0 || live * tuner.valueBytes <= tuner.memoryBudget) && parallelism >= tuner.minParallelism;
+	check(c.feasible == feasible,"feasibility " + name);
+}
+
+/*
+ * Checks the rule that picked the chosen candidate
+ */
+static void checkChoice(BlockTuner &tuner, ull chosen, string name) {
+	check(tuner.best < tuner.candidates.size() && tuner.candidates[tuner.best].block == chosen,"chosen block " + name);
+	BlockTuner::Candidate &b = tuner.candidates[tuner.best];
+
+	bool anyFeasible = false;
+	for(unsigned i=0; i<tuner.candidates.size(); i++)
+		anyFeasible = anyFeasible || tuner.candidates[i].feasible;
+
+	bool ok = b.feasible == anyFeasible;
+	for(unsigned i=0; i<tuner.candidates.size(); i++) {
+		BlockTuner::Candidate &c = tuner.candidates[i];
+		if(anyFeasible && c.feasible)
+			ok = ok && (b.memAccesses < c.memAccesses || (b.memAccesses == c.memAccesses && b.maxLive <= c.maxLive));
+		if(!anyFeasible)
+			ok = ok && b.maxLive <= c.maxLive;
+	}
+	check(ok,"choice rule " + name);
+}
+
+static void tuneDot(BlockTuner &tuner, ull size, string name) {
+	ull chosen = tuner.tuneDotProduct(size);
+
+	KernelGraphs generator(1);
+	vector<ull> blocks;
+	for(unsigned i=0; i<tuner.candidates.size(); i++) {
+		BlockTuner::Candidate &c = tuner.candidates[i];
+		blocks.push_back(c.block);
+		CSRGraph graph;
+		generator.dotProductBlockedRead(size,c.block,graph);
+		checkCandidate(tuner,c,graph,name + " block " + to_string(c.block));
+	}
+	vector<ull> divisors;
+	for(ull b=1; b<=size; b++)
+		if(size % b == 0)
+			divisors.push_back(b);
+	check(blocks == divisors,"candidates " + name);
+	checkChoice(tuner,chosen,name);
+}
+
+static void tuneMultiply(BlockTuner &tuner, ull m1size, ull m2size, string name) {
+	ull chosen = tuner.tuneBlockMultiply(m1size,m2size);
+
+	KernelGraphs generator(1);
+	vector<ull> blocks;
+	for(unsigned i=0; i<tuner.candidates.size(); i++) {
+		BlockTuner::Candidate &c = tuner.candidates[i];
+		blocks.push_back(c.block);
+		CSRGraph graph;
+		generator.matrixMatrixBlockMultiply(m1size,m2size,c.block,graph);
+		checkCandidate(tuner,c,graph,name + " block " + to_string(c.block));
+	}
+	vector<ull> divisors;
+	for(ull b=1; b<=m1size && b<=m2size; b++)
+		if(m1size % b == 0 && m2size % b == 0)
+			divisors.push_back(b);
+	check(blocks == divisors,"candidates " + name);
+	checkChoice(tuner,chosen,name);
+}
+
+int main() {
+	BlockTuner tuner(2);
+
+	//no limits: every block size is feasible
+	tuneDot(tuner,24,"dot product 24");
+	tuneMultiply(tuner,8,12,"multiply 8x12");
+	check(tuner.tuneBlockMultiply(8,8) == 8,"multiply 8x8 without a budget");
+
+	//a budget of 6 values leaves blocks 1 and 2 (block 4 keeps 20 values
+	//live, block 8 keeps 8)
+	tuner.memoryBudget = 6 * tuner.valueBytes;
+	tuneDot(tuner,24,"dot product 24 with a budget");
+	tuneMultiply(tuner,8,12,"multiply 8x12 with a budget");
+	tuneMultiply(tuner,8,8,"multiply 8x8 with a budget");
+	check(tuner.candidates[tuner.best].block == 2 && !tuner.candidates[2].feasible && !tuner.candidates[3].feasible,"multiply 8x8 with a budget");
+
+	//64x64: the whole matrix without a budget, block 4 with 50 values
+	tuner.memoryBudget = 0;
+	check(tuner.tuneBlockMultiply(64,64) == 64,"multiply 64x64 without a budget");
+	tuner.memoryBudget = 50 * tuner.valueBytes;
+	check(tuner.tuneBlockMultiply(64,64) == 4,"multiply 64x64 with a budget");
+
+	//a budget no block size fits: fall back to the fewest live values
+	tuner.memoryBudget = 1;
+	tuneDot(tuner,24,"dot product 24 with no feasible block");
+	tuneMultiply(tuner,8,12,"multiply 8x12 with no feasible block");
+
+	//the parallelism target filters as well
+	tuner.memoryBudget = 0;
+	tuner.minParallelism = 3;
+	tuneDot(tuner,24,"dot product 24 with a parallelism target");
+	tuneMultiply(tuner,8,8,"multiply 8x8 with a parallelism target");
+	tuner.minParallelism = 1e9;
+	tuneMultiply(tuner,8,8,"multiply 8x8 with an unreachable parallelism target");
+
+	return checked("blockTuner");
+}
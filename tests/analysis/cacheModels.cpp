@@ -0,0 +1,105 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * cacheModels.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks the cache memory models against hand computed traces and against
+ * a straightforward LRU reference on random traces
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "MemoryModel.h"
+#include "check.h"
+
+using namespace std;
+
+//replays the byte addresses and returns "H"/"M" per access
+static string replay(MemoryModel &model, vector<long long unsigned> addrs) {
+	string result;
+	for(unsigned i=0; i<addrs.size(); i++)
+		result += model.access(addrs[i]) ? "H" : "M";
+	return result;
+}
+
+//LRU reference: one vector per set, most recently used first
+static bool referenceAccess(vector<vector<long long unsigned> > &sets, unsigned ways, long long unsigned line) {
+	vector<long long unsigned> &set = sets[line % sets.size()];
+	for(unsigned w=0; w<set.size(); w++) {
+		if(set[w] == line) {
+			set.erase(set.begin()+w);
+			set.insert(set.begin(),line);
+			return true;
+		}
+	}
+	set.insert(set.begin(),line);
+	if(set.size() > ways)
+		set.pop_back();
+	return false;
+}
+
+int main() {
+	//4 lines of 8 bytes: lines 0 1 2 3 0 4 1 0 2
+	LRUCache lru(32,8);
+	long long unsigned lruTrace[] = {0,8,16,24,0,32,8,4,16};
+	check(replay(lru,vector<long long unsigned>(lruTrace,lruTrace+9)) == "MMMMHMMHM","LRU hand trace");
+	check(lru.hits == 2 && lru.misses == 7,"LRU hit and miss counts");
+
+	//2 sets of 2 ways: set 0 sees lines 0 2 4 0 2, set 1 sees 1 3 1
+	SetAssociativeCache assoc(32,8,2);
+	long long unsigned assocTrace[] = {0,16,32,0,16,8,24,8};
+	check(replay(assoc,vector<long long unsigned>(assocTrace,assocTrace+8)) == "MMMMMMMH","set associative hand trace");
+
+	assoc.reset();
+	check(assoc.hits == 0 && assoc.misses == 0 && replay(assoc,vector<long long unsigned>(1,0)) == "M","set associative reset");
+
+	//random traces against the reference, a single set is fully associative
+	srand(1);
+	unsigned configs[][3] = {{256,8,1},{256,8,4},{512,16,2},{256,8,32}};
+	for(unsigned c=0; c<4; c++) {
+		long long unsigned capacity = configs[c][0], lineSize = configs[c][1];
+		unsigned ways = configs[c][2];
+		SetAssociativeCache model(capacity,lineSize,ways);
+		LRUCache full(capacity,lineSize);
+		vector<vector<long long unsigned> > sets(capacity/(lineSize*ways));
+		vector<vector<long long unsigned> > fullSet(1);
+
+		bool same = true, sameFull = true;
+		for(unsigned i=0; i<20000; i++) {
+			long long unsigned addr = rand() % (capacity*3);
+			long long unsigned line = addr / lineSize;
+			if(model.access(addr) != referenceAccess(sets,ways,line))
+				same = false;
+			if(full.access(addr) != referenceAccess(fullSet,capacity/lineSize,line))
+				sameFull = false;
+		}
+
+		char name[64];
+		snprintf(name,sizeof(name),"%llu bytes, %llu byte lines, %u ways",capacity,lineSize,ways);
+		check(same,string("set associative random trace: ") + name);
+		check(sameFull,string("LRU random trace: ") + name);
+	}
+
+	return checked("cacheModels");
+}
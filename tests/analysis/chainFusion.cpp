@@ -0,0 +1,178 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * chainFusion.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks ChainFusion on random graphs: every op ends up in exactly one
+ * fused node, fused nodes are paths of elementwise ops each feeding only
+ * the next, edges between fused nodes are exactly the edges between their
+ * members, and the memory accesses of the graph are unchanged. A traced
+ * chain reading more values than a node type can hold checks the exact
+ * memory accesses and the line written by writeFusion.
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+
+#include "Data.h"
+#include "CSRGraph.h"
+#include "ChainFusion.h"
+#include "randomGraph.h"
+#include "check.h"
+
+using namespace std;
+
+typedef Data<double> D;
+typedef pair<long long unsigned,long long unsigned> Edge;
+
+static long long unsigned memAccesses(CSRGraph &graph) {
+	long long unsigned count = 0;
+	for(long long unsigned i=0; i<graph.nodes; i++)
+		count += graph.memType(i);
+	return count;
+}
+
+static bool hasEdge(CSRGraph &graph, long long unsigned u, long long unsigned v) {
+	for(long long unsigned e=graph.succOffset[u]; e<graph.succOffset[u+1]; e++)
+		if(graph.succ[e] == v)
+			return true;
+	return false;
+}
+
+/*
+ * Checks the fused graph against the graph it was built from
+ */
+static void checkFusion(CSRGraph &graph, ChainFusion &fusion, CSRGraph &result, vector<long long unsigned> &outputs, string name) {
+	long long unsigned n = graph.nodes;
+	check(result.nodes == fusion.original.size() && result.nodes + fusion.fused == n,"node count " + name);
+	check(memAccesses(result) == memAccesses(graph),"memory accesses " + name);
+
+	//every op is a member of exactly one fused node
+	vector<long long unsigned> owner(n,result.nodes);
+	bool members = true;
+	for(long long unsigned k=0; k<result.nodes; k++) {
+		for(long long unsigned m=fusion.memberOffset[k]; m<fusion.memberOffset[k+1]; m++) {
+			members = members && owner[fusion.member[m]] == result.nodes;
+			owner[fusion.member[m]] = k;
+		}
+	}
+	for(long long unsigned i=0; i<n; i++)
+		members = members && owner[i] < result.nodes;
+	check(members,"members " + name);
+
+	//fused nodes are paths of elementwise ops, only the last one has other consumers
+	bool paths = true;
+	bool costs = true;
+	for(long long unsigned k=0; k<result.nodes; k++) {
+		long long unsigned first = fusion.memberOffset[k];
+		long long unsigned last = fusion.memberOffset[k+1]-1;
+		long long unsigned cost = 0;
+		long long unsigned mem = 0;
+		for(long long unsigned m=first; m<=last; m++) {
+			unsigned i = fusion.member[m];
+			cost += fusion.getLatency(graph.opType(i));
+			mem += graph.memType(i);
+			if(m == last)
+				continue;
+			bool output = find(outputs.begin(),outputs.end(),i) != outputs.end();
+			paths = paths && !output && graph.outDegree(i) == 1 && graph.succ[graph.succOffset[i]] == fusion.member[m+1];
+			paths = paths && ChainFusion::elementwise(graph.opType(i)) && ChainFusion::elementwise(graph.opType(fusion.member[m+1]));
+		}
+		paths = paths && fusion.original[k] == fusion.member[last];
+		paths = paths && (fusion.maxLength == 0 || last - first + 1 <= fusion.maxLength);
+		costs = costs && fusion.cost[k] == cost && fusion.memory[k] == mem && (unsigned long long)result.memType(k) == mem;
+		if(last > first)
+			costs = costs && result.opType(k) == Types::Fused;
+		else
+			costs = costs && result.type[k] == graph.type[fusion.member[first]];
+	}
+	check(paths,"chains " + name);
+	check(costs,"cost and memory of the fused nodes " + name);
+
+	//an edge between two fused nodes for every edge between their members
+	set<Edge> expected;
+	for(long long unsigned u=0; u<n; u++)
+		for(long long unsigned e=graph.succOffset[u]; e<graph.succOffset[u+1]; e++)
+			if(owner[u] != owner[graph.succ[e]])
+				expected.insert(Edge(owner[u],owner[graph.succ[e]]));
+	bool edges = expected.size() == result.edges;
+	for(set<Edge>::iterator it=expected.begin(); it!=expected.end(); ++it)
+		edges = edges && hasEdge(result,it->first,it->second);
+	check(edges,"edges " + name);
+}
+
+int main() {
+	for(unsigned seed=1; seed<=8; seed++) {
+		CSRGraph graph;
+		randomGraph(600,1+seed%2,10+seed*5,seed,graph);
+
+		//a few results that must end their chains
+		vector<long long unsigned> outputs;
+		for(long long unsigned i=seed; i<graph.nodes; i+=97)
+			outputs.push_back(i);
+
+		char name[32];
+		for(unsigned maxLength=0; maxLength<=3; maxLength+=3) {
+			snprintf(name,sizeof(name),"seed %u max length %u",seed,maxLength);
+			ChainFusion fusion(maxLength);
+			fusion.setLatency(Types::Mult,3);
+			fusion.setLatency(Types::Div,10);
+			CSRGraph result;
+			fusion.fuse(graph,result,&outputs);
+			check(fusion.chains > 0,string("chains found ") + name);
+			checkFusion(graph,fusion,result,outputs,name);
+		}
+	}
+
+	//one chain of five ops reading six values, more than a node type holds
+	D::debug = false;
+	D a, b, c, d, e, f;
+	D x = a + b;
+	D y = x - c;
+	D z = y * d;
+	D w = z / e;
+	D r = w + f;
+	r.markOutput();
+
+	CSRGraph traced(*D::getMatrix(),opCount);
+	ChainFusion fusion;
+	fusion.setLatency(Types::Mult,3);
+	CSRGraph result;
+	fusion.fuse(traced,result,&D::getOutputs());
+	checkFusion(traced,fusion,result,D::getOutputs(),"traced chain");
+	check(result.nodes == 1 && fusion.chains == 1 && result.memType(0) == 6,"traced chain memory accesses");
+	check(Types::getMemType(result.type[0]) == 4,"traced chain type");
+
+	fusion.writeFusion(traced,"fusion.txt");
+	FILE *fp = fopen("fusion.txt","r");
+	char line[256] = "";
+	if(fp != NULL) {
+		if(fgets(line,sizeof(line),fp) == NULL)
+			line[0] = 0;
+		fclose(fp);
+	}
+	check(string(line) == "0 7 6 Add Sub Mult Div Add\n","writeFusion line");
+
+	return checked("chainFusion");
+}
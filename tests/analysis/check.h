@@ -0,0 +1,54 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * check.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <stdio.h>
+#include <string>
+
+#ifndef _CHECK_
+#define _CHECK_
+
+using namespace std;
+
+static unsigned failures = 0;
+
+/*
+ * Reports a failed condition, what describes it
+ */
+static void check(bool ok, string what) {
+	if(!ok) {
+		printf("FAILED: %s\n",what.c_str());
+		failures++;
+	}
+}
+
+/*
+ * Returns the exit status of the named check, printing "name: OK" if none
+ * of its conditions failed
+ */
+static int checked(const char *name) {
+	if(failures > 0)
+		return 1;
+	printf("%s: OK\n",name);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,196 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * compressedGraph.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks that a CompressedGraph gives back exactly the graph it was built
+ * from: built while tracing (Data::setCompressor), built afterwards with
+ * compress, and after a writeCompressed/readCompressed round trip. The
+ * tracing state of Data can not be reset, so every trace runs in its own
+ * child process and hands its graphs back through files.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "Data.h"
+#include "linearAlgebra.h"
+#include "CSRGraph.h"
+#include "CompressedGraph.h"
+#include "check.h"
+
+using namespace std;
+
+typedef Data<double> D;
+typedef LinearAlgebra<D> LA;
+
+static const char *kernels[] = {"dotProduct", "blockedDotProduct", "matrixMultiply", "blockMultiply", "cse", "pruning"};
+
+/*
+ * Traces one kernel, the last two with common subexpressions and dead
+ * node elimination turned on
+ */
+static void trace(unsigned kernel) {
+	if(kernel == 0) {
+		D result = LA::dotProductRead(64,64);
+		result.markOutput();
+	}
+	else if(kernel == 1) {
+		D result = LA::dotProductBlockedRead(64,64,8);
+		result.markOutput();
+	}
+	else if(kernel == 2) {
+		LA::matrix a(6,LA::array(6)), b(6,LA::array(6));
+		LA::matrix c = LA::matrixMatrixMultiply(&a,&b);
+	}
+	else if(kernel == 3)
+		LA::matrixMatrixBlockMultiply(8,8,4);
+	else {
+		//every product is computed twice, half of them with the operands swapped
+		LA::array a(16), b(16);
+		for(unsigned i=0; i<a.size(); i++) {
+			D p = a[i] * b[i];
+			D q = (i % 2 == 0) ? b[i] * a[i] : a[i] * b[i];
+			D r = p + q;
+			if(i % 4 == 0)
+				r.markOutput();
+		}
+	}
+}
+
+/*
+ * Traces a kernel in a child process with a compressor attached, writing
+ * the sparse matrix, the compressed graph and the outputs
+ */
+static bool traceChild(unsigned kernel) {
+	pid_t pid = fork();
+	if(pid == 0) {
+		CompressedGraph compressed;
+		D::debug = false;
+		D::setCSE(kernel >= 4);
+		D::setPruning(kernel == 5);
+		D::setCompressor(&compressed,true);
+		trace(kernel);
+		compressed.finish();
+
+		D::writeSparseMatrix("tracedGraph.txt");
+		compressed.writeCompressed("tracedCompressed.txt");
+		FILE *fp = fopen("tracedOutputs.txt","w");
+		vector<long long unsigned> &outputs = D::getOutputs();
+		for(long long unsigned k=0; k<outputs.size(); k++)
+			fprintf(fp,"%llu\n",outputs[k]);
+		fclose(fp);
+		_exit(0);
+	}
+
+	int status = 1;
+	waitpid(pid,&status,0);
+	return pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static vector<long long unsigned> readNumbers(string filename) {
+	vector<long long unsigned> numbers;
+	FILE *fp = fopen(filename.c_str(),"r");
+	long long unsigned x;
+	while(fp != NULL && fscanf(fp,"%llu",&x) == 1)
+		numbers.push_back(x);
+	if(fp != NULL)
+		fclose(fp);
+	return numbers;
+}
+
+static bool sameGraph(CSRGraph &a, CSRGraph &b) {
+	return a.nodes == b.nodes && a.edges == b.edges && a.type == b.type &&
+		a.succOffset == b.succOffset && a.succ == b.succ &&
+		a.predOffset == b.predOffset && a.pred == b.pred;
+}
+
+static bool sameSymbols(CompressedGraph &a, CompressedGraph &b) {
+	if(a.symbols.size() != b.symbols.size() || a.items != b.items)
+		return false;
+	for(unsigned s=0; s<a.symbols.size(); s++) {
+		CompressedGraph::Symbol &x = a.symbols[s], &y = b.symbols[s];
+		if(x.run != y.run || x.affine != y.affine || x.type != y.type || x.offsets != y.offsets ||
+				x.body != y.body || x.delta != y.delta || x.count != y.count ||
+				x.nodes != y.nodes || x.edges != y.edges)
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Compresses a graph, writes and reads it back and checks both expand to
+ * the graph again
+ */
+static void roundTrip(CSRGraph &graph, string name) {
+	CompressedGraph compressed, read;
+	compressed.compress(graph);
+	CSRGraph expanded, reread;
+	compressed.expand(expanded);
+	check(sameGraph(graph,expanded),"compress and expand " + name);
+	check(compressed.nodes() == graph.nodes && compressed.edges() == graph.edges,"compressed size " + name);
+
+	compressed.writeCompressed("offlineCompressed.txt");
+	check(read.readCompressed("offlineCompressed.txt"),"reading " + name);
+	check(sameSymbols(compressed,read),"symbols read back " + name);
+	read.expand(reread);
+	check(sameGraph(graph,reread),"read and expand " + name);
+}
+
+int main() {
+	for(unsigned kernel=0; kernel<6; kernel++) {
+		string name = kernels[kernel];
+		bool ran = traceChild(kernel);
+		check(ran,"tracing " + name);
+		if(!ran)
+			continue;
+
+		CSRGraph traced;
+		traced.readSparseMatrix("tracedGraph.txt");
+		check(traced.nodes > 0 && traced.edges > 0,"traced graph " + name);
+
+		//compressed while tracing, dead node elimination only applies to the matrix
+		CompressedGraph online;
+		CSRGraph expanded;
+		check(online.readCompressed("tracedCompressed.txt"),"reading traced " + name);
+		online.expand(expanded);
+		if(kernel != 5)
+			check(sameGraph(traced,expanded),"traced and expanded " + name);
+		else
+			check(expanded.nodes == traced.nodes && expanded.edges > traced.edges,"pruned nodes are kept " + name);
+
+		roundTrip(traced,name);
+
+		//the compacted live graph after a pruning post pass
+		vector<long long unsigned> outputs = readNumbers("tracedOutputs.txt");
+		if(outputs.size() > 0) {
+			CSRGraph live;
+			traced.prune(outputs,live);
+			roundTrip(live,name + " pruned");
+		}
+	}
+
+	return checked("compressedGraph");
+}
@@ -0,0 +1,159 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * cse.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks common subexpression detection (Data::setCSE): Add and Mult
+ * match with their operands in either order while Sub and Div do not, and
+ * the recursive Fibonacci of the fibonacci test, whose arguments are all
+ * computed from constants, is traced once per argument instead of once
+ * per call. The tracing state of Data can not be reset, so every trace
+ * runs in its own child process and hands its counts back through a file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "Data.h"
+#include "linearAlgebra.h"
+#include "CSRGraph.h"
+#include "check.h"
+
+using namespace std;
+
+typedef Data<double> D;
+typedef LinearAlgebra<D> LA;
+
+//argument of the traced Fibonacci
+static const unsigned fibArgument = 10;
+
+/*
+ * Every op applied to two memory reads twice, once with the operands
+ * swapped and once in the same order
+ */
+static void traceOperands() {
+	LA::array a(2);
+	D add = a[0] + a[1], addSwapped = a[1] + a[0];
+	D mult = a[0] * a[1], multSwapped = a[1] * a[0];
+	D sub = a[0] - a[1], subSwapped = a[1] - a[0], subAgain = a[0] - a[1];
+	D div = a[0] / a[1], divSwapped = a[1] / a[0], divAgain = a[0] / a[1];
+}
+
+static D fib1(D i) {
+	D one(1);
+	D two(2);
+
+	if(i < two)
+		return i;
+
+	one = fib1(i - one);
+	two = fib1(i - two);
+
+	D result = one + two;
+
+	return result;
+}
+
+static void traceFibonacci() {
+	D num(fibArgument);
+	D result = fib1(num);
+	check(result == D(55),"fibonacci value");
+}
+
+/*
+ * Traces in a child process and writes the number of ops, the number of
+ * reused nodes and the number of nodes of each type
+ */
+static bool traceChild(void (*run)(), bool cse, vector<long long unsigned> &counts) {
+	counts.clear();
+	pid_t pid = fork();
+	if(pid == 0) {
+		D::debug = false;
+		D::setCSE(cse);
+		run();
+		if(failures > 0)
+			_exit(1);
+
+		CSRGraph graph(*D::getMatrix(),opCount);
+		vector<long long unsigned> types(Types::user,0);
+		for(long long unsigned i=0; i<graph.nodes; i++)
+			types[graph.opType(i)]++;
+		FILE *fp = fopen("cseCounts.txt","w");
+		fprintf(fp,"%llu %llu",opCount,D::getDeduplicated());
+		for(unsigned t=0; t<types.size(); t++)
+			fprintf(fp," %llu",types[t]);
+		fprintf(fp,"\n");
+		fclose(fp);
+		_exit(0);
+	}
+
+	int status = 1;
+	waitpid(pid,&status,0);
+	if(pid <= 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		return false;
+
+	FILE *fp = fopen("cseCounts.txt","r");
+	long long unsigned x;
+	while(fp != NULL && fscanf(fp,"%llu",&x) == 1)
+		counts.push_back(x);
+	if(fp != NULL)
+		fclose(fp);
+	return counts.size() == Types::user+2;
+}
+
+int main() {
+	vector<long long unsigned> off, on;
+
+	check(traceChild(traceOperands,false,off) && traceChild(traceOperands,true,on),"tracing operands");
+	if(off.size() > 0 && on.size() > 0) {
+		check(off[0] == 10 && off[1] == 0,"ops without CSE");
+		//the swapped Add and Mult and the repeated Sub and Div are reused
+		check(on[0] == 6 && on[1] == 4,"ops with CSE " + to_string(on[0]));
+		check(on[2+Types::Add] == 1 && on[2+Types::Mult] == 1,"commutative ops merged");
+		check(on[2+Types::Sub] == 2 && on[2+Types::Div] == 2,"swapped Sub and Div kept apart");
+	}
+
+	//each call above the base cases traces two Subs and an Add, with CSE
+	//each argument from fibArgument down to 2 does
+	long long unsigned calls = 0, previous = 0, current = 1;
+	for(unsigned k=1; k<=fibArgument; k++) {
+		long long unsigned next = previous + current;
+		previous = current;
+		current = next;
+	}
+	calls = current - 1;
+	long long unsigned arguments = fibArgument - 1;
+
+	check(traceChild(traceFibonacci,false,off) && traceChild(traceFibonacci,true,on),"tracing fibonacci");
+	if(off.size() > 0 && on.size() > 0) {
+		check(off[0] == 3*calls && off[1] == 0,"fibonacci ops without CSE " + to_string(off[0]));
+		check(off[2+Types::Sub] == 2*calls && off[2+Types::Add] == calls,"fibonacci types without CSE");
+		check(on[0] == 3*arguments,"fibonacci ops with CSE " + to_string(on[0]));
+		check(on[2+Types::Sub] == 2*arguments && on[2+Types::Add] == arguments,"fibonacci types with CSE");
+		check(on[0] + on[1] == off[0],"fibonacci reused nodes");
+	}
+
+	return checked("cse");
+}
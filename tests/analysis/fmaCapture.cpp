@@ -0,0 +1,255 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * fmaCapture.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks FMA capture (Data::setFMA). With capture off, products written
+ * inline trace the same graph as products stored in variables first, and
+ * stored products are never fused even with capture on. With capture on,
+ * every product added to a value becomes one FMA node with the operands
+ * of both ops. Products used with the other operators (%, comparisons,
+ * compound assignments) still trace as a Mult node feeding the op. Every
+ * trace runs in its own child process, as the tracing state of Data can
+ * not be reset.
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "Data.h"
+#include "linearAlgebra.h"
+#include "CSRGraph.h"
+#include "check.h"
+
+using namespace std;
+
+typedef Data<double> D;
+typedef LinearAlgebra<D> LA;
+typedef Data<int> DI;
+
+//products added to a value in the inline kernel
+static const long long unsigned fused = 11;
+
+/*
+ * The same computation with its products inline, or stored in variables
+ * before they are used
+ */
+static void trace(bool inlined) {
+	//every element is used once, so each operand of an op is a node or a memory read
+	LA::array a(8), b(8), c(8), d(8), e(8);
+
+	if(inlined) {
+		D acc = a[0] * b[0] + c[0];
+		for(unsigned i=1; i<8; i++)
+			acc += a[i] * b[i];
+		D s = c[1] + d[0] * e[0];
+		D t = d[1] * e[1] + d[2] * e[2];
+		D u = d[3] * e[3] - c[2];
+		D v = d[4] * e[4] * c[3];
+		D w = acc + s;
+		D x = t * u + v;
+		w.markOutput();
+		x.markOutput();
+	}
+	else {
+		D p0 = a[0] * b[0];
+		D acc = p0 + c[0];
+		for(unsigned i=1; i<8; i++) {
+			D p = a[i] * b[i];
+			acc += D(p);
+		}
+		D p1 = d[0] * e[0];
+		D s = c[1] + p1;
+		D p2 = d[1] * e[1];
+		D p3 = d[2] * e[2];
+		D t = p2 + p3;
+		D p4 = d[3] * e[3];
+		D u = p4 - c[2];
+		D p5 = d[4] * e[4];
+		D v = p5 * c[3];
+		D w = acc + s;
+		D p6 = t * u;
+		D x = p6 + v;
+		w.markOutput();
+		x.markOutput();
+	}
+}
+
+/*
+ * Products used with the operators that can not fuse them, inline or
+ * stored in variables before they are used
+ */
+static void traceOther(bool inlined) {
+	//nonzero constants so % is defined
+	vector<DI> a, b, c;
+	for(unsigned i=0; i<8; i++) {
+		a.push_back(DI(i+2));
+		b.push_back(DI(i+3));
+		c.push_back(DI(i+5));
+	}
+
+	if(inlined) {
+		DI m = (a[0] * b[0]) % c[0];
+		DI n = c[1] % (a[1] * b[1]);
+		bool less = (a[2] * b[2]) < c[2];
+		bool more = (a[3] * b[3]) >= (a[4] * b[4]);
+		DI q = c[3];
+		q -= a[5] * b[5];
+		q %= a[6] * b[6];
+		DI r = m + n;
+		r.markOutput();
+		q.markOutput();
+		check(!less && !more,"product comparisons");
+	}
+	else {
+		DI p0 = a[0] * b[0];
+		DI m = p0 % c[0];
+		DI p1 = a[1] * b[1];
+		DI n = c[1] % p1;
+		DI p2 = a[2] * b[2];
+		bool less = p2 < c[2];
+		DI p3 = a[3] * b[3];
+		DI p4 = a[4] * b[4];
+		bool more = p3 >= p4;
+		DI q = c[3];
+		DI p5 = a[5] * b[5];
+		q -= p5;
+		DI p6 = a[6] * b[6];
+		q %= p6;
+		DI r = m + n;
+		r.markOutput();
+		q.markOutput();
+		check(!less && !more,"stored product comparisons");
+	}
+}
+
+/*
+ * Traces in a child process and writes the graph and the FMA count
+ */
+template <class V>
+static bool traceChild(void (*run)(bool), bool inlined, bool fma, CSRGraph &graph, long long unsigned &fmas) {
+	pid_t pid = fork();
+	if(pid == 0) {
+		V::debug = false;
+		V::setFMA(fma);
+		run(inlined);
+		if(failures > 0)
+			_exit(1);
+
+		V::writeSparseMatrix("fmaGraph.txt");
+		FILE *fp = fopen("fmaCount.txt","w");
+		fprintf(fp,"%llu\n",V::getFMAs());
+		fclose(fp);
+		_exit(0);
+	}
+
+	int status = 1;
+	waitpid(pid,&status,0);
+	if(pid <= 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		return false;
+
+	FILE *fp = fopen("fmaCount.txt","r");
+	bool ok = fp != NULL && fscanf(fp,"%llu",&fmas) == 1;
+	if(fp != NULL)
+		fclose(fp);
+	return ok && graph.readSparseMatrix("fmaGraph.txt");
+}
+
+static bool same(CSRGraph &g1, CSRGraph &g2) {
+	return g1.nodes == g2.nodes && g1.type == g2.type && g1.succOffset == g2.succOffset && g1.succ == g2.succ;
+}
+
+static long long unsigned countOps(CSRGraph &graph, int op) {
+	long long unsigned count = 0;
+	for(long long unsigned i=0; i<graph.nodes; i++)
+		if(graph.opType(i) == op)
+			count++;
+	return count;
+}
+
+static long long unsigned memAccesses(CSRGraph &graph) {
+	long long unsigned count = 0;
+	for(long long unsigned i=0; i<graph.nodes; i++)
+		count += graph.memType(i);
+	return count;
+}
+
+static long long unsigned depth(CSRGraph &graph) {
+	vector<long long unsigned> level = graph.levels();
+	long long unsigned d = 0;
+	for(long long unsigned i=0; i<level.size(); i++)
+		if(level[i]+1 > d)
+			d = level[i]+1;
+	return d;
+}
+
+int main() {
+	CSRGraph inlineOff, storedOff, storedOn, inlineOn;
+	long long unsigned fmas[4];
+	bool ran = traceChild<D>(trace,true,false,inlineOff,fmas[0]) && traceChild<D>(trace,false,false,storedOff,fmas[1]) &&
+			traceChild<D>(trace,false,true,storedOn,fmas[2]) && traceChild<D>(trace,true,true,inlineOn,fmas[3]);
+	check(ran,"tracing");
+	if(!ran)
+		return 1;
+
+	//capture off: inline products trace as a Mult feeding an Add, like stored ones
+	check(same(inlineOff,storedOff),"inline and stored products without capture");
+	check(fmas[0] == 0 && fmas[1] == 0,"no FMAs without capture");
+	check(countOps(inlineOff,Types::FMA) == 0,"no FMA nodes without capture");
+
+	//a product stored in a variable is never fused
+	check(same(storedOn,storedOff),"stored products with capture");
+	check(fmas[2] == 0,"no FMAs for stored products");
+
+	//capture on: every fused Mult and Add pair becomes one FMA node
+	check(fmas[3] == fused && countOps(inlineOn,Types::FMA) == fused,"FMA count");
+	check(inlineOn.nodes == inlineOff.nodes - fused,"node count with capture");
+	check(countOps(inlineOn,Types::Mult) == countOps(inlineOff,Types::Mult) - fused,"Mult nodes with capture");
+	check(countOps(inlineOn,Types::Add) == countOps(inlineOff,Types::Add) - fused,"Add nodes with capture");
+	check(countOps(inlineOn,Types::Sub) == countOps(inlineOff,Types::Sub),"Sub nodes with capture");
+	check(memAccesses(inlineOn) == memAccesses(inlineOff),"memory accesses with capture");
+	check(depth(inlineOn) <= depth(inlineOff),"depth with capture");
+
+	//every FMA node reads its three operands from other nodes or memory
+	bool operands = true;
+	for(long long unsigned i=0; i<inlineOn.nodes; i++)
+		if(inlineOn.opType(i) == Types::FMA)
+			operands = operands && inlineOn.inDegree(i) + inlineOn.memType(i) == 3;
+	check(operands,"FMA operands");
+
+	//the other operators take a product like a value, with or without capture
+	CSRGraph otherInline, otherStored, otherInlineOn;
+	long long unsigned otherFmas[3];
+	ran = traceChild<DI>(traceOther,true,false,otherInline,otherFmas[0]) && traceChild<DI>(traceOther,false,false,otherStored,otherFmas[1]) &&
+			traceChild<DI>(traceOther,true,true,otherInlineOn,otherFmas[2]);
+	check(ran,"tracing the other operators");
+	if(!ran)
+		return 1;
+	check(same(otherInline,otherStored),"inline and stored products with the other operators");
+	check(same(otherInlineOn,otherStored),"the other operators with capture");
+	check(countOps(otherInline,Types::Mult) == 7 && countOps(otherInline,Types::Mod) == 3,"Mult and Mod nodes");
+	check(otherFmas[2] == 0,"no FMAs with the other operators");
+
+	return checked("fmaCapture");
+}
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * heftMapper.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks that HEFTMapper produces valid mappings (every dependence waits
+ * for its transfer, no processor runs two nodes at once) and that limiting
+ * the search to the earliest available processor of each class and the
+ * processors of the predecessors finds the same earliest finish time as
+ * trying every processor
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "CSRGraph.h"
+#include "HEFTMapper.h"
+#include "randomGraph.h"
+#include "check.h"
+
+using namespace std;
+
+static bool same(double a, double b) {
+	return fabs(a-b) <= 1e-9 * max(1.0,fabs(a));
+}
+
+int main() {
+	unsigned configs[][2] = {{1,0},{1,1},{2,1},{3,2},{0,3},{4,4}};
+
+	for(unsigned seed=1; seed<=10; seed++) {
+		CSRGraph graph;
+		randomGraph(400,2,30,seed,graph);
+		long long unsigned n = graph.nodes;
+
+		HEFTMapper heft(graph,2,8);
+		heft.setCost(0,Types::Add,1.0);
+		heft.setCost(0,Types::Mult,4.0);
+		heft.setCost(0,Types::Div,9.0);
+		heft.setCost(1,Types::Add,2.0);
+		heft.setCost(1,Types::Mult,1.5);
+		heft.setCost(1,Types::Div,2.5);
+		heft.bandwidth = 4.0;
+		heft.linkLatency = 0.5;
+		heft.nodeBytes.assign(n,8);
+		for(long long unsigned i=0; i<n; i+=7)
+			heft.nodeBytes[i] = 32;
+		heft.rank();
+
+		//the rank order is a topological order
+		vector<long long unsigned> position(n);
+		for(long long unsigned k=0; k<n; k++)
+			position[heft.order[k]] = k;
+		bool topological = true;
+		for(long long unsigned i=0; i<n; i++) {
+			for(long long unsigned e=graph.predOffset[i]; e<graph.predOffset[i+1]; e++)
+				topological = topological && position[graph.pred[e]] < position[i];
+		}
+		check(topological,"rank order seed " + to_string(seed));
+
+		for(unsigned c=0; c<6; c++) {
+			vector<unsigned> processors(configs[c],configs[c]+2);
+			heft.map(processors);
+			string name = "seed " + to_string(seed) + " config " + to_string(c);
+
+			vector<unsigned> classOf;
+			for(unsigned k=0; k<2; k++)
+				classOf.insert(classOf.end(),processors[k],k);
+			unsigned procs = classOf.size();
+
+			//replay the mapping in rank order, at every step the chosen
+			//finish must be the earliest over all processors
+			vector<double> availableAt(procs,0.0);
+			bool valid = true, earliest = true;
+			double makespan = 0;
+			for(long long unsigned k=0; k<n; k++) {
+				unsigned node = heft.order[k];
+				unsigned p = heft.processor[node];
+				int op = graph.opType(node);
+
+				valid = valid && p < procs && heft.processorClass[node] == classOf[p];
+				valid = valid && same(heft.finish[node],heft.start[node] + heft.getCost(classOf[p],op));
+				valid = valid && heft.start[node] >= availableAt[p] - 1e-9;
+				for(long long unsigned e=graph.predOffset[node]; e<graph.predOffset[node+1]; e++) {
+					unsigned src = graph.pred[e];
+					double arrive = heft.finish[src] + ((heft.processor[src] != p) ? heft.commCost(src) : 0.0);
+					valid = valid && heft.start[node] >= arrive - 1e-9;
+				}
+
+				double best = -1;
+				for(unsigned q=0; q<procs; q++) {
+					double ready = availableAt[q];
+					for(long long unsigned e=graph.predOffset[node]; e<graph.predOffset[node+1]; e++) {
+						unsigned src = graph.pred[e];
+						double arrive = heft.finish[src];
+						if(heft.processor[src] != q)
+							arrive += heft.commCost(src);
+						ready = max(ready,arrive);
+					}
+					double f = ready + heft.getCost(classOf[q],op);
+					if(best < 0 || f < best)
+						best = f;
+				}
+				earliest = earliest && same(heft.finish[node],best);
+
+				availableAt[p] = heft.finish[node];
+				makespan = max(makespan,heft.finish[node]);
+			}
+
+			check(valid,"valid mapping " + name);
+			check(earliest,"earliest finish " + name);
+			check(same(heft.makespan,makespan),"makespan " + name);
+		}
+	}
+
+	return checked("heftMapper");
+}
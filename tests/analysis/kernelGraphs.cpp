@@ -0,0 +1,103 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * kernelGraphs.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks that KernelGraphs generates exactly the graphs that tracing the
+ * LinearAlgebra kernels produces (node types and edges) for small sizes,
+ * including sizes that are not a power of 2. Every trace runs in its own
+ * child process, as the tracing state of Data can not be reset.
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "Data.h"
+#include "linearAlgebra.h"
+#include "CSRGraph.h"
+#include "KernelGraphs.h"
+#include "check.h"
+
+using namespace std;
+
+typedef Data<double> D;
+typedef LinearAlgebra<D> LA;
+
+/*
+ * Traces one kernel in a child process and reads back its graph
+ */
+static bool traceKernel(unsigned kernel, unsigned a, unsigned b, unsigned c, CSRGraph &graph) {
+	pid_t pid = fork();
+	if(pid == 0) {
+		D::debug = false;
+		if(kernel == 0)
+			LA::dotProductRead(a,a);
+		else if(kernel == 1)
+			LA::dotProductBlockedRead(a,a,b);
+		else
+			LA::matrixMatrixBlockMultiply(a,b,c);
+		D::writeSparseMatrix("kernelGraph.txt");
+		_exit(0);
+	}
+
+	int status = 1;
+	waitpid(pid,&status,0);
+	if(pid <= 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		return false;
+	return graph.readSparseMatrix("kernelGraph.txt");
+}
+
+static bool same(CSRGraph &g1, CSRGraph &g2) {
+	return g1.nodes == g2.nodes && g1.type == g2.type && g1.succOffset == g2.succOffset && g1.succ == g2.succ;
+}
+
+int main() {
+	KernelGraphs generator(2);
+
+	for(unsigned size=1; size<=40; size++) {
+		CSRGraph traced, generated;
+		generator.dotProductRead(size,generated);
+		check(traceKernel(0,size,0,0,traced) && same(traced,generated),"dotProductRead " + to_string(size));
+	}
+
+	for(unsigned size=2; size<=48; size++) {
+		for(unsigned block=1; block<=size; block++) {
+			if(size % block != 0)
+				continue;
+			CSRGraph traced, generated;
+			generator.dotProductBlockedRead(size,block,generated);
+			check(traceKernel(1,size,block,0,traced) && same(traced,generated),"dotProductBlockedRead " + to_string(size) + " " + to_string(block));
+		}
+	}
+
+	unsigned multiplies[][3] = {{2,2,1},{2,2,2},{4,4,2},{6,3,3},{3,6,3},{6,6,2},{8,4,4},{4,8,2},{5,5,5}};
+	for(unsigned k=0; k<9; k++) {
+		unsigned *m = multiplies[k];
+		CSRGraph traced, generated;
+		generator.matrixMatrixBlockMultiply(m[0],m[1],m[2],generated);
+		check(traceKernel(2,m[0],m[1],m[2],traced) && same(traced,generated),"matrixMatrixBlockMultiply " + to_string(m[0]) + " " + to_string(m[1]) + " " + to_string(m[2]));
+	}
+
+	return checked("kernelGraphs");
+}
@@ -0,0 +1,105 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * levelsSlack.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks the ASAP and ALAP levels and the slack of CSRGraph against a brute
+ * force relaxation over the edge list, and that the balanced levels stay
+ * in range and keep every dependence
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "CSRGraph.h"
+#include "randomGraph.h"
+#include "check.h"
+
+using namespace std;
+
+int main() {
+	for(unsigned seed=1; seed<=20; seed++) {
+		CSRGraph graph;
+		randomGraph(500,2,40,seed,graph);
+		long long unsigned n = graph.nodes;
+
+		//relax every edge until nothing changes: longest path from the
+		//inputs (ASAP) and to the outputs (height)
+		vector<long long unsigned> asap(n,0), height(n,0);
+		bool changed = true;
+		while(changed) {
+			changed = false;
+			for(long long unsigned u=0; u<n; u++) {
+				for(long long unsigned e=graph.succOffset[u]; e<graph.succOffset[u+1]; e++) {
+					long long unsigned v = graph.succ[e];
+					if(asap[v] < asap[u]+1) {
+						asap[v] = asap[u]+1;
+						changed = true;
+					}
+					if(height[u] < height[v]+1) {
+						height[u] = height[v]+1;
+						changed = true;
+					}
+				}
+			}
+		}
+
+		long long unsigned depth = 0;
+		for(long long unsigned i=0; i<n; i++)
+			if(asap[i]+1 > depth)
+				depth = asap[i]+1;
+
+		vector<long long unsigned> level = graph.levels();
+		vector<long long unsigned> alap = graph.alapLevels(level);
+		vector<long long unsigned> mobility = graph.slack(level,alap);
+		vector<long long unsigned> balanced = graph.balancedLevels(level,alap);
+
+		bool alapOk = true, slackOk = true, balancedOk = true;
+		for(long long unsigned i=0; i<n; i++) {
+			if(alap[i] != depth-1-height[i])
+				alapOk = false;
+			if(mobility[i] != alap[i]-asap[i])
+				slackOk = false;
+			if(balanced[i] < level[i] || balanced[i] > alap[i])
+				balancedOk = false;
+			for(long long unsigned e=graph.succOffset[i]; e<graph.succOffset[i+1]; e++)
+				if(balanced[graph.succ[e]] <= balanced[i])
+					balancedOk = false;
+		}
+
+		//balancing keeps the depth and every node
+		vector<long long unsigned> after = CSRGraph::stageHistogram(balanced);
+		long long unsigned placed = 0;
+		for(long long unsigned l=0; l<after.size(); l++)
+			placed += after[l];
+
+		char name[64];
+		snprintf(name,sizeof(name)," (seed %u)",seed);
+		check(level == asap,string("ASAP levels") + name);
+		check(alapOk,string("ALAP levels") + name);
+		check(slackOk,string("slack") + name);
+		check(balancedOk,string("balanced levels within range and ordered") + name);
+		check(after.size() == depth && placed == n,string("balanced stages") + name);
+	}
+
+	return checked("levelsSlack");
+}
@@ -0,0 +1,124 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * listScheduler.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks that ListScheduler schedules respect every dependence, unit limit
+ * and memory port limit, and that with unlimited resources the makespan is
+ * the latency weighted critical path
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "ListScheduler.h"
+#include "randomGraph.h"
+#include "check.h"
+
+using namespace std;
+
+//checks the schedule against the graph and the scheduler's resources
+static bool valid(CSRGraph &graph, ListScheduler &s) {
+	long long unsigned end = 0;
+	for(long long unsigned i=0; i<graph.nodes; i++) {
+		long long unsigned finish = s.start[i] + s.getLatency(graph.opType(i));
+		if(finish > end)
+			end = finish;
+		for(long long unsigned e=graph.succOffset[i]; e<graph.succOffset[i+1]; e++)
+			if(s.start[graph.succ[e]] < finish)
+				return false;
+	}
+	if(end != s.makespan)
+		return false;
+
+	//units busy and memory ports used in each cycle
+	vector<vector<unsigned> > used(s.makespan+1,vector<unsigned>(Types::user,0));
+	vector<unsigned> ports(s.makespan+1,0);
+	vector<unsigned> memOps(s.makespan+1,0);
+	for(long long unsigned i=0; i<graph.nodes; i++) {
+		int op = graph.opType(i);
+		long long unsigned busy = s.pipelined ? 1 : s.getLatency(op);
+		for(long long unsigned c=s.start[i]; c<s.start[i]+busy; c++)
+			used[c][op]++;
+		ports[s.start[i]] += graph.memType(i);
+		if(graph.memType(i) > 0)
+			memOps[s.start[i]]++;
+	}
+
+	for(long long unsigned c=0; c<=s.makespan; c++) {
+		for(int op=0; op<Types::user; op++)
+			if(s.getUnits(op) > 0 && used[c][op] > s.getUnits(op))
+				return false;
+		//an op needing more ports than there are may only go alone
+		if(s.memPorts > 0 && ports[c] > s.memPorts && memOps[c] > 1)
+			return false;
+	}
+	return true;
+}
+
+int main() {
+	for(unsigned seed=1; seed<=20; seed++) {
+		CSRGraph graph;
+		randomGraph(400,2,30,seed,graph);
+
+		//unlimited resources: the makespan is the weighted longest path
+		ListScheduler unlimited;
+		unlimited.setResource(Types::Mult,3,0);
+		unlimited.setResource(Types::Div,7,0);
+		unlimited.schedule(graph);
+
+		vector<long long unsigned> finish(graph.nodes,0);
+		long long unsigned longest = 0;
+		for(long long unsigned i=0; i<graph.nodes; i++) {
+			long long unsigned ready = 0;
+			for(long long unsigned e=graph.predOffset[i]; e<graph.predOffset[i+1]; e++)
+				if(finish[graph.pred[e]] > ready)
+					ready = finish[graph.pred[e]];
+			finish[i] = ready + unlimited.getLatency(graph.opType(i));
+			if(finish[i] > longest)
+				longest = finish[i];
+		}
+
+		char name[64];
+		snprintf(name,sizeof(name)," (seed %u)",seed);
+		check(valid(graph,unlimited),string("unlimited schedule") + name);
+		check(unlimited.makespan == longest,string("unlimited makespan is the critical path") + name);
+
+		for(unsigned p=0; p<2; p++) {
+			ListScheduler limited;
+			limited.pipelined = (p == 0);
+			limited.setResource(Types::Add,1,2);
+			limited.setResource(Types::Sub,1,1);
+			limited.setResource(Types::Mult,3,1);
+			limited.setResource(Types::Div,7,1);
+			limited.memPorts = 1;
+			limited.schedule(graph);
+
+			check(valid(graph,limited),string(limited.pipelined ? "pipelined" : "unpipelined") + " limited schedule" + name);
+			check(limited.makespan >= longest,string("limited makespan is at least the critical path") + name);
+		}
+	}
+
+	return checked("listScheduler");
+}
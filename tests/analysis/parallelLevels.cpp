@@ -0,0 +1,102 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * parallelLevels.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks the levels, depth and weighted longest path of ParallelLevels
+ * against the serial CSRGraph::levels and a sequential longest path, for
+ * several thread counts and with the wavefronts forced onto the work queues
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "CSRGraph.h"
+#include "ParallelLevels.h"
+#include "randomGraph.h"
+#include "check.h"
+
+using namespace std;
+
+int main() {
+	vector<unsigned> latency(Types::user,1);
+	latency[Types::Mult] = 3;
+	latency[Types::Div] = 7;
+
+	for(unsigned seed=1; seed<=10; seed++) {
+		CSRGraph graph;
+		randomGraph(5000,2,200,seed,graph);
+		long long unsigned n = graph.nodes;
+
+		vector<long long unsigned> level = graph.levels();
+		long long unsigned depth = 0;
+		for(long long unsigned i=0; i<n; i++) {
+			if(level[i]+1 > depth)
+				depth = level[i]+1;
+		}
+
+		//ids are a topological order, so one pass gives the finish times
+		vector<long long unsigned> finish(n,0);
+		long long unsigned longest = 0;
+		for(long long unsigned i=0; i<n; i++) {
+			long long unsigned start = 0;
+			for(long long unsigned e=graph.predOffset[i]; e<graph.predOffset[i+1]; e++) {
+				if(finish[graph.pred[e]] > start)
+					start = finish[graph.pred[e]];
+			}
+			finish[i] = start + latency[graph.opType(i)];
+			if(finish[i] > longest)
+				longest = finish[i];
+		}
+
+		unsigned threadCounts[] = {1,2,4};
+		for(unsigned t=0; t<3; t++) {
+			for(unsigned forced=0; forced<2; forced++) {
+				ParallelLevels par(threadCounts[t]);
+				if(forced) {
+					//small chunks and no serial wavefronts so every thread steals
+					par.chunkSize = 7;
+					par.serialThreshold = 0;
+				}
+				string name = "seed " + to_string(seed) + " threads " + to_string(threadCounts[t]) + (forced ? " forced" : "");
+
+				check(par.compute(graph) == depth, "depth " + name);
+				check(par.level == level, "levels " + name);
+				check(par.finish.empty() && par.longestPath == 0, "unweighted " + name);
+
+				par.latency = latency;
+				par.compute(graph);
+				check(par.depth == depth && par.level == level, "weighted levels " + name);
+				check(par.finish == finish, "finish times " + name);
+				check(par.longestPath == longest, "longest path " + name);
+			}
+		}
+	}
+
+	//empty graph
+	CSRGraph empty;
+	randomGraph(0,2,10,1,empty);
+	ParallelLevels par(2);
+	check(par.compute(empty) == 0 && par.level.empty(), "empty graph");
+
+	return checked("parallelLevels");
+}
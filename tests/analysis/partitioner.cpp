@@ -0,0 +1,111 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * partitioner.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks that the Partitioner assigns every node, that its per part
+ * totals, cut and volume match a recount from the part ids, that every
+ * part is within the balance limits, and that the cut beats dealing the nodes
+ * out round robin
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+
+#include "CSRGraph.h"
+#include "Partitioner.h"
+#include "randomGraph.h"
+#include "check.h"
+
+using namespace std;
+
+int main() {
+	unsigned partCounts[] = {1,2,4,7,16};
+
+	for(unsigned seed=1; seed<=6; seed++) {
+		CSRGraph graph;
+		randomGraph(20000,2,100,seed,graph);
+		long long unsigned n = graph.nodes;
+
+		long long unsigned totalMem = 0;
+		for(long long unsigned i=0; i<n; i++)
+			totalMem += graph.memType(i);
+
+		for(unsigned t=0; t<5; t++) {
+			unsigned k = partCounts[t];
+			Partitioner partitioner(k);
+			long long unsigned cut = partitioner.partition(graph);
+			string name = "seed " + to_string(seed) + " parts " + to_string(k);
+
+			bool assigned = partitioner.part.size() == n;
+			for(long long unsigned i=0; assigned && i<n; i++)
+				assigned = partitioner.part[i] < k;
+			check(assigned,"assigned " + name);
+			if(!assigned)
+				continue;
+
+			//recount everything from the part ids
+			vector<long long unsigned> ops(k,0), mem(k,0), partCut(k,0);
+			long long unsigned edgesCut = 0, volume = 0, spreadCut = 0;
+			for(long long unsigned i=0; i<n; i++) {
+				unsigned p = partitioner.part[i];
+				ops[p]++;
+				mem[p] += graph.memType(i);
+				set<unsigned> sentTo;
+				for(long long unsigned e=graph.succOffset[i]; e<graph.succOffset[i+1]; e++) {
+					unsigned q = partitioner.part[graph.succ[e]];
+					if(q != p) {
+						edgesCut++;
+						partCut[p]++;
+						sentTo.insert(q);
+					}
+					if(i%k != graph.succ[e]%k)
+						spreadCut++;
+				}
+				volume += sentTo.size();
+			}
+
+			check(cut == edgesCut && partitioner.cut == edgesCut,"cut " + name);
+			check(partitioner.volume == volume,"volume " + name);
+			check(partitioner.partOps == ops,"part ops " + name);
+			check(partitioner.partMem == mem,"part mem " + name);
+			check(partitioner.partCut == partCut,"part cut " + name);
+
+			//a part may exceed the average by the imbalance or by one node
+			long long unsigned limOps = max((long long unsigned)((1+partitioner.imbalance)*n/k),n/k + 1);
+			long long unsigned limMem = max((long long unsigned)((1+partitioner.imbalance)*totalMem/k),totalMem/k + 2);
+			bool balanced = true;
+			for(unsigned p=0; p<k; p++)
+				balanced = balanced && ops[p] <= limOps && mem[p] <= limMem;
+			check(balanced,"balance " + name);
+
+			if(k == 1)
+				check(cut == 0,"single part " + name);
+			else
+				check(cut < spreadCut,"better than round robin " + name);
+		}
+	}
+
+	return checked("partitioner");
+}
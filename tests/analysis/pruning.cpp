@@ -0,0 +1,194 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * pruning.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks online dead node elimination (Data::setPruning) against the
+ * CSRGraph::prune post pass: once the gaps left by the removed nodes are
+ * compacted both give the same graph. Also checks that common
+ * subexpression detection never hands back a node that was pruned. The
+ * tracing state of Data can not be reset, so every trace runs in its own
+ * child process and hands its graph back through files.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "Data.h"
+#include "linearAlgebra.h"
+#include "CSRGraph.h"
+#include "check.h"
+
+using namespace std;
+
+typedef Data<double> D;
+typedef LinearAlgebra<D> LA;
+
+static const char *kernels[] = {"dotProduct", "fibonacci", "partialSums", "matrixMultiply", "deadReuse"};
+
+static D fib1(D i) {
+	D one(1);
+	D two(2);
+
+	if(i < two)
+		return i;
+
+	one = fib1(i - one);
+	two = fib1(i - two);
+
+	D result = one + two;
+
+	return result;
+}
+
+/*
+ * Traces one kernel and marks its results as outputs
+ */
+static void trace(unsigned kernel) {
+	if(kernel == 0) {
+		//the first dot product is never used
+		D unused = LA::dotProductRead(32,32);
+		D result = LA::dotProductRead(32,32);
+		result.markOutput();
+	}
+	else if(kernel == 1) {
+		D num(8);
+		D result = fib1(num);
+		result.markOutput();
+	}
+	else if(kernel == 2) {
+		//the sums after the last output are dead
+		LA::array a(23);
+		D sum = a[0] + a[1];
+		for(unsigned i=2; i<a.size(); i++) {
+			if(i % 5 == 0)
+				sum.markOutput();
+			sum = sum - a[i];
+		}
+	}
+	else if(kernel == 3) {
+		//only the diagonal of the result is needed
+		LA::matrix a(6,LA::array(6)), b(6,LA::array(6));
+		LA::matrix c = LA::matrixMatrixMultiply(&a,&b);
+		for(unsigned i=0; i<c.size(); i++)
+			c[i][i].markOutput();
+	}
+	else {
+		//p is dead before the same sum is traced again, so q needs a new node
+		LA::array a(2);
+		{
+			D p = a[0] + a[1];
+		}
+		D q = a[1] + a[0];
+		q.markOutput();
+		D r = a[0] + a[1];
+		r.markOutput();
+	}
+}
+
+/*
+ * Traces a kernel in a child process, writing its graph, outputs and the
+ * number of ops, reused nodes and pruned nodes
+ */
+static bool traceChild(unsigned kernel, bool pruning, string prefix) {
+	pid_t pid = fork();
+	if(pid == 0) {
+		D::debug = false;
+		D::setPruning(pruning);
+		D::setCSE(kernel == 4);
+		trace(kernel);
+
+		D::writeSparseMatrix(prefix + "Graph.txt");
+		FILE *fp = fopen((prefix + "Outputs.txt").c_str(),"w");
+		vector<long long unsigned> &outputs = D::getOutputs();
+		for(long long unsigned k=0; k<outputs.size(); k++)
+			fprintf(fp,"%llu\n",outputs[k]);
+		fclose(fp);
+		fp = fopen((prefix + "Counts.txt").c_str(),"w");
+		fprintf(fp,"%llu %llu %llu\n",opCount,D::getDeduplicated(),D::getPruned());
+		fclose(fp);
+		_exit(0);
+	}
+
+	int status = 1;
+	waitpid(pid,&status,0);
+	return pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static vector<long long unsigned> readNumbers(string filename) {
+	vector<long long unsigned> numbers;
+	FILE *fp = fopen(filename.c_str(),"r");
+	long long unsigned x;
+	while(fp != NULL && fscanf(fp,"%llu",&x) == 1)
+		numbers.push_back(x);
+	if(fp != NULL)
+		fclose(fp);
+	return numbers;
+}
+
+int main() {
+	for(unsigned kernel=0; kernel<4; kernel++) {
+		string name = kernels[kernel];
+		bool ran = traceChild(kernel,false,"offline") && traceChild(kernel,true,"online");
+		check(ran,"tracing " + name);
+		if(!ran)
+			continue;
+
+		CSRGraph graph, offline, traced, online;
+		graph.readSparseMatrix("offlineGraph.txt");
+		vector<long long unsigned> outputs = readNumbers("offlineOutputs.txt");
+		graph.prune(outputs,offline);
+
+		traced.readSparseMatrix("onlineGraph.txt");
+		vector<long long unsigned> onlineOutputs = readNumbers("onlineOutputs.txt");
+		vector<long long unsigned> counts = readNumbers("onlineCounts.txt");
+		traced.prune(onlineOutputs,online);
+
+		//the ops are traced the same way, pruned nodes are only left out of the matrix
+		long long unsigned remaining = 0;
+		for(long long unsigned i=0; i<traced.nodes; i++)
+			if(traced.type[i] != 0)
+				remaining++;
+		check(counts.size() == 3 && counts[0] == graph.nodes && onlineOutputs == outputs,"ops traced " + name);
+		check(counts.size() == 3 && remaining + counts[2] == traced.nodes,"pruned count " + name);
+		check(counts.size() == 3 && (kernel == 1 || counts[2] > 0),"dead nodes pruned " + name);
+
+		check(offline.nodes == online.nodes && offline.edges == online.edges,"graph size " + name);
+		check(offline.type == online.type,"node types " + name);
+		check(offline.succ == online.succ && offline.succOffset == online.succOffset,"edges " + name);
+	}
+
+	//a node pruned while tracing is never reused
+	check(traceChild(4,true,"online"),"tracing deadReuse");
+	CSRGraph traced;
+	traced.readSparseMatrix("onlineGraph.txt");
+	vector<long long unsigned> outputs = readNumbers("onlineOutputs.txt");
+	vector<long long unsigned> counts = readNumbers("onlineCounts.txt");
+	check(counts.size() == 3 && counts[0] == 2 && counts[1] == 1 && counts[2] == 1,"dead reuse counts");
+	check(outputs.size() == 2 && outputs[0] == 1 && outputs[1] == 1,"dead reuse outputs");
+	check(traced.nodes == 2 && traced.type[0] == 0 && traced.opType(1) == Types::Add,"dead reuse graph");
+
+	return checked("pruning");
+}
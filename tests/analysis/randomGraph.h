@@ -0,0 +1,71 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * randomGraph.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <stdlib.h>
+#include <vector>
+
+#include "Graph.h"
+#include "CSRGraph.h"
+
+#ifndef _RANDOMGRAPH_
+#define _RANDOMGRAPH_
+
+using namespace std;
+
+/*
+ * Builds a random graph shaped like a trace: ids are a topological order,
+ * every node has up to maxPreds predecessors among the previous window
+ * nodes, and inputs it does not get from other nodes are memory accesses
+ * (at most two operands per node, like a traced op)
+ */
+static void randomGraph(unsigned nodes, unsigned maxPreds, unsigned window, unsigned seed, CSRGraph &graph) {
+	srand(seed);
+	int ops[] = {Types::Add, Types::Mult, Types::Sub, Types::Div};
+
+	vector<int> types(nodes);
+	vector<pair<unsigned,unsigned> > edgeList;
+	for(unsigned i=0; i<nodes; i++) {
+		unsigned preds = 0;
+		unsigned want = (i > 0) ? rand() % (maxPreds+1) : 0;
+		for(unsigned k=0; k<want; k++) {
+			unsigned range = (i < window) ? i : window;
+			unsigned p = i - 1 - rand() % range;
+
+			bool dup = false;
+			for(unsigned e=edgeList.size()-preds; e<edgeList.size(); e++)
+				if(edgeList[e].first == p)
+					dup = true;
+			if(dup)
+				continue;
+
+			edgeList.push_back(make_pair(p,i));
+			preds++;
+		}
+
+		int mem = (preds < 2) ? rand() % (3 - preds) : 0;
+		types[i] = Types::setMemType(mem) + ops[rand() % 4];
+	}
+
+	graph.build(nodes,types,edgeList);
+}
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * reductionTrees.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks that collapsing reduction trees while tracing (Data::setReduce)
+ * gives the same graph and the same Reduce nodes as tracing normally and
+ * running ReductionTrees::collapse afterwards, and that neither changes
+ * the total memory accesses of the graph. The tracing state of Data can
+ * not be reset, so every trace runs in its own child process and hands
+ * its graph back through files.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "Data.h"
+#include "linearAlgebra.h"
+#include "CSRGraph.h"
+#include "ReductionTrees.h"
+#include "check.h"
+
+using namespace std;
+
+typedef Data<double> D;
+typedef LinearAlgebra<D> LA;
+//arity, depth and memory accesses of a Reduce node
+typedef pair<pair<long long unsigned,long long unsigned>,long long unsigned> Shape;
+
+static const char *kernels[] = {"dotProduct", "reductionNeg", "blockedDotProduct", "matrixMultiply", "prefixSums"};
+
+/*
+ * Traces one kernel and marks its results as outputs
+ */
+static void trace(unsigned kernel) {
+	if(kernel == 0) {
+		D result = LA::dotProductRead(64,64);
+		result.markOutput();
+	}
+	else if(kernel == 1) {
+		LA::array a(37);
+		D result = LA::reductionNeg(&a);
+		result.markOutput();
+	}
+	else if(kernel == 2) {
+		D result = LA::dotProductBlockedRead(64,64,8);
+		result.markOutput();
+	}
+	else if(kernel == 3) {
+		//accumulation chains
+		unsigned n = 6;
+		LA::matrix a(n,LA::array(n)), b(n,LA::array(n));
+		for(unsigned i=0; i<n; i++) {
+			for(unsigned j=0; j<n; j++) {
+				D sum = a[i][0] * b[0][j];
+				for(unsigned k=1; k<n; k++)
+					sum = sum + a[i][k] * b[k][j];
+				sum.markOutput();
+			}
+		}
+	}
+	else {
+		//every partial sum is a result, so nothing can be absorbed past it
+		LA::array a(20);
+		D sum = a[0] + a[1];
+		for(unsigned i=2; i<a.size(); i++) {
+			if(i % 5 == 0)
+				sum.markOutput();
+			sum = sum - a[i];
+		}
+		sum.markOutput();
+	}
+}
+
+static long long unsigned memAccesses(CSRGraph &graph) {
+	long long unsigned count = 0;
+	for(long long unsigned i=0; i<graph.nodes; i++)
+		count += graph.memType(i);
+	return count;
+}
+
+/*
+ * Traces a kernel in a child process, writing its graph, outputs and the
+ * Reduce nodes made while tracing (when reducing)
+ */
+static bool traceChild(unsigned kernel, bool reduce, string prefix) {
+	pid_t pid = fork();
+	if(pid == 0) {
+		D::debug = false;
+		D::setReduce(reduce);
+		trace(kernel);
+
+		D::writeSparseMatrix(prefix + "Graph.txt");
+		D::writeReductions(prefix + "Reductions.txt");
+		FILE *fp = fopen((prefix + "Outputs.txt").c_str(),"w");
+		vector<long long unsigned> &outputs = D::getOutputs();
+		for(long long unsigned k=0; k<outputs.size(); k++)
+			fprintf(fp,"%llu\n",outputs[k]);
+		fclose(fp);
+
+		//memory accesses of the traced graph with the exact Reduce counts
+		CSRGraph graph(*D::getMatrix(),opCount);
+		D::exactMemory(graph);
+		fp = fopen((prefix + "Memory.txt").c_str(),"w");
+		fprintf(fp,"%llu\n",memAccesses(graph));
+		fclose(fp);
+		_exit(0);
+	}
+
+	int status = 1;
+	waitpid(pid,&status,0);
+	return pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static vector<long long unsigned> readNumbers(string filename) {
+	vector<long long unsigned> numbers;
+	FILE *fp = fopen(filename.c_str(),"r");
+	long long unsigned x;
+	while(fp != NULL && fscanf(fp,"%llu",&x) == 1)
+		numbers.push_back(x);
+	if(fp != NULL)
+		fclose(fp);
+	return numbers;
+}
+
+int main() {
+	for(unsigned kernel=0; kernel<5; kernel++) {
+		string name = kernels[kernel];
+		bool ran = traceChild(kernel,false,"offline") && traceChild(kernel,true,"online");
+		check(ran,"tracing " + name);
+		if(!ran)
+			continue;
+
+		//offline: remove dead nodes then collapse the trees
+		CSRGraph graph, live, offline;
+		graph.readSparseMatrix("offlineGraph.txt");
+		vector<long long unsigned> outputs = readNumbers("offlineOutputs.txt");
+		vector<unsigned> original = graph.prune(outputs,live);
+		vector<long long unsigned> liveOutputs;
+		for(long long unsigned k=0; k<original.size(); k++)
+			if(find(outputs.begin(),outputs.end(),original[k]) != outputs.end())
+				liveOutputs.push_back(k);
+		ReductionTrees trees;
+		trees.collapse(live,offline,&liveOutputs);
+
+		//online: the collapsed trees are already in the graph, only the gaps
+		//left by the absorbed nodes need compacting. The file holds at most
+		//4 memory accesses per node, the exact counts come with the Reduce
+		//nodes.
+		CSRGraph traced, online;
+		traced.readSparseMatrix("onlineGraph.txt");
+		vector<long long unsigned> lines = readNumbers("onlineReductions.txt");
+		for(long long unsigned k=0; k+3<lines.size(); k+=4)
+			traced.setMemory(lines[k],lines[k+3]);
+		vector<long long unsigned> onlineOutputs = readNumbers("onlineOutputs.txt");
+		traced.prune(onlineOutputs,online);
+
+		//collapsing moves memory accesses into the Reduce nodes without losing any
+		long long unsigned total = memAccesses(live);
+		vector<long long unsigned> onlineTotal = readNumbers("onlineMemory.txt");
+		check(total > 0 && memAccesses(offline) == total,"memory accesses offline " + name);
+		check(memAccesses(online) == total,"memory accesses online " + name);
+		check(onlineTotal.size() == 1 && onlineTotal[0] == total,"memory accesses while tracing " + name);
+
+		check(offline.nodes == online.nodes && offline.edges == online.edges,"graph size " + name);
+		check(offline.type == online.type,"node types " + name);
+		check(offline.succ == online.succ && offline.succOffset == online.succOffset,"edges " + name);
+
+		vector<Shape> offlineShapes, onlineShapes;
+		for(long long unsigned i=0; i<trees.arity.size(); i++)
+			if(trees.arity[i] > 0)
+				offlineShapes.push_back(Shape(make_pair(trees.arity[i],trees.depth[i]),trees.memory[i]));
+		for(long long unsigned k=0; k+3<lines.size(); k+=4)
+			onlineShapes.push_back(Shape(make_pair(lines[k+1],lines[k+2]),lines[k+3]));
+		sort(offlineShapes.begin(),offlineShapes.end());
+		sort(onlineShapes.begin(),onlineShapes.end());
+		check(offlineShapes.size() > 0 && offlineShapes == onlineShapes,"reduce shapes " + name);
+	}
+
+	return checked("reductionTrees");
+}
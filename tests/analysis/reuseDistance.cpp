@@ -0,0 +1,109 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * reuseDistance.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks ReuseDistance against a brute force count of the distinct lines
+ * between reuses, and its level assignment against LRU caches of the same
+ * capacities
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+
+#include "MemoryModel.h"
+#include "ReuseDistance.h"
+#include "check.h"
+
+using namespace std;
+
+int main() {
+	srand(2);
+
+	//long enough to compact the time slots several times
+	long long unsigned lineSize = 8;
+	vector<long long unsigned> trace;
+	for(unsigned i=0; i<30000; i++) {
+		//mostly a small working set with occasional far accesses
+		if(rand() % 8 == 0)
+			trace.push_back(rand() % 40000);
+		else
+			trace.push_back(rand() % 800);
+	}
+
+	ReuseDistance reuse(lineSize);
+	vector<long long unsigned> capacities;
+	capacities.push_back(64);
+	capacities.push_back(512);
+	capacities.push_back(4096);
+	reuse.setLevels(capacities);
+	for(unsigned i=0; i<trace.size(); i++)
+		reuse.access(trace[i]);
+
+	//brute force: distinct lines since the previous access to the same line
+	vector<long long unsigned> histogram;
+	long long unsigned cold = 0;
+	map<long long unsigned,unsigned> previous;
+	for(unsigned i=0; i<trace.size(); i++) {
+		long long unsigned line = trace[i] / lineSize;
+		map<long long unsigned,unsigned>::iterator it = previous.find(line);
+		if(it == previous.end())
+			cold++;
+		else {
+			set<long long unsigned> distinct;
+			for(unsigned j=it->second+1; j<i; j++)
+				distinct.insert(trace[j] / lineSize);
+			if(histogram.size() <= distinct.size())
+				histogram.resize(distinct.size()+1,0);
+			histogram[distinct.size()]++;
+		}
+		previous[line] = i;
+	}
+
+	check(reuse.accesses == trace.size(),"access count");
+	check(reuse.coldMisses == cold,"cold misses");
+	check(reuse.histogram == histogram,"reuse distance histogram");
+
+	//an access reaches a level exactly when it misses in all smaller LRU memories
+	vector<long long unsigned> counts = reuse.levelCounts(capacities);
+	vector<long long unsigned> lruHits;
+	for(unsigned l=0; l<capacities.size(); l++) {
+		LRUCache cache(capacities[l],lineSize);
+		for(unsigned i=0; i<trace.size(); i++)
+			cache.access(trace[i]);
+		lruHits.push_back(cache.hits);
+	}
+
+	bool levels = true;
+	for(unsigned l=0; l<capacities.size(); l++)
+		if(counts[l] != lruHits[l] - (l > 0 ? lruHits[l-1] : 0))
+			levels = false;
+	if(counts[capacities.size()] != trace.size() - lruHits.back())
+		levels = false;
+	check(levels,"level counts against LRU caches");
+	check(reuse.levelAccesses == counts,"online level assignment against the histogram");
+
+	return checked("reuseDistance");
+}
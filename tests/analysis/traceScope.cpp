@@ -0,0 +1,182 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * traceScope.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks the TraceScope profile of an instrumented Cholesky decomposition
+ * against a brute force relaxation over the edges of each instance, and
+ * on a small hand traced example
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "Data.h"
+#include "linearAlgebra.h"
+#include "CSRGraph.h"
+#include "TraceScope.h"
+#include "check.h"
+
+using namespace std;
+
+typedef Data<double> D;
+typedef LinearAlgebra<D> LA;
+
+/*
+ * LinearAlgebra::choleskyDecomposition with its row, Z, R and diagonal
+ * phases marked as regions
+ */
+static LA::cholResult choleskyDecomposition(LA::matrix *m1) {
+	LA::cholResult result(m1->size());
+
+	//set first iteration results
+	result.diag.push_back(m1->at(0)[0]);
+
+	//loop through each row (except first)
+	for(unsigned i = 1; i<m1->size(); i++) {
+		TraceScope row("cholesky_row");
+
+		//calculate Z's
+		LA::array Z(i);
+		{
+			TraceScope scope("cholesky_z");
+			for(unsigned j=0; j<Z.size(); j++) {
+				//calculate multiplies Lji * Zi
+				if(j > 0) {
+					LA::array Zmult(j);
+					for(unsigned k=0; k<j; k++) {
+						Zmult[k] = result.lower[j][k] * Z[k];
+					}
+
+					//sum the multiplies
+					D sum = LA::reduction(&Zmult);
+
+					//calculate Z value
+					Z[j] = m1->at(i)[j] - sum;
+				}
+				else
+					Z[j] = m1->at(i)[j];
+			}
+		}
+
+		//calculate R's
+		LA::array R(i);
+		{
+			TraceScope scope("cholesky_r");
+			for(unsigned j=0; j<R.size(); j++) {
+				R[j] = Z[j]/result.diag[j];
+				result.lower[i][j] = R[j];
+			}
+		}
+
+		//calculate diag
+		//calculate sum of Ri^2 * Di
+		{
+			TraceScope scope("cholesky_diag");
+			LA::array Rmult(i);
+			for(unsigned j=0; j<i; j++) {
+				Rmult[j] = R[j]*R[j]*result.diag[j];
+			}
+
+			D sum = LA::reduction(&Rmult);
+
+			result.diag[i] = m1->at(i)[i] - sum;
+		}
+	}
+
+	return result;
+}
+
+int main() {
+	D::debug = false;
+
+	//hand example: x is computed before the scope, so inside it p (level 0)
+	//and q (level 3) are both at depth 1 and each instance has span 1
+	LA::array a(8);
+	D x = a[0] + a[1];
+	x = x * a[2];
+	x = x - a[3];
+	for(unsigned k=0; k<2; k++) {
+		TraceScope scope("independent");
+		D p = a[4] * a[5];
+		D q = x + a[6];
+	}
+	long long unsigned handEnd = opCount;
+
+	LA::matrix m(12,LA::array(12));
+	LA::cholResult result = choleskyDecomposition(&m);
+
+	CSRGraph graph(*D::getMatrix(),opCount);
+	TraceScope::profile(graph);
+
+	TraceScope::Region &hand = TraceScope::regions[0];
+	check(hand.name == "independent" && hand.instances == 2,"hand example regions");
+	check(hand.work == 4 && hand.span == 2 && hand.width == 2,"hand example span " + to_string(hand.span));
+	check(hand.ranges.back().second == handEnd,"hand example range");
+
+	//relax the edges of each instance until nothing changes
+	for(unsigned r=0; r<TraceScope::regions.size(); r++) {
+		TraceScope::Region &region = TraceScope::regions[r];
+		long long unsigned work = 0, mem = 0, span = 0, width = 0;
+
+		for(unsigned k=0; k<region.ranges.size(); k++) {
+			long long unsigned first = region.ranges[k].first, last = region.ranges[k].second;
+			vector<long long unsigned> depth(last-first,1);
+			bool changed = true;
+			while(changed) {
+				changed = false;
+				for(long long unsigned u=first; u<last; u++) {
+					for(long long unsigned e=graph.succOffset[u]; e<graph.succOffset[u+1]; e++) {
+						long long unsigned v = graph.succ[e];
+						if(v < last && depth[v-first] < depth[u-first]+1) {
+							depth[v-first] = depth[u-first]+1;
+							changed = true;
+						}
+					}
+				}
+			}
+
+			long long unsigned deepest = 0;
+			vector<long long unsigned> count(last-first+1,0);
+			for(long long unsigned i=first; i<last; i++) {
+				work++;
+				mem += graph.memType(i);
+				count[depth[i-first]]++;
+				if(depth[i-first] > deepest)
+					deepest = depth[i-first];
+			}
+			span += deepest;
+			for(long long unsigned d=0; d<count.size(); d++)
+				if(count[d] > width)
+					width = count[d];
+		}
+
+		string name = region.name;
+		check(region.work == work && region.memAccesses == mem,"work " + name);
+		check(region.span == span,"span " + name + " " + to_string(region.span) + " " + to_string(span));
+		check(region.width == width,"width " + name);
+		check(region.span > 0 && region.span <= region.work,"span in range " + name);
+	}
+	check(TraceScope::regions.size() == 5,"regions");
+
+	return checked("traceScope");
+}
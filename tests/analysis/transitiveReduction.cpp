@@ -0,0 +1,109 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * transitiveReduction.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+/*
+ * Checks TransitiveReduction against a naive reduction that removes an
+ * edge u->v whenever v can be reached from another successor of u, for
+ * several block sizes and thread counts
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "CSRGraph.h"
+#include "TransitiveReduction.h"
+#include "randomGraph.h"
+#include "check.h"
+
+using namespace std;
+
+typedef pair<long long unsigned,long long unsigned> Edge;
+
+static vector<Edge> edgesOf(CSRGraph &graph) {
+	vector<Edge> edges;
+	for(long long unsigned u=0; u<graph.nodes; u++) {
+		for(long long unsigned e=graph.succOffset[u]; e<graph.succOffset[u+1]; e++)
+			edges.push_back(Edge(u,graph.succ[e]));
+	}
+	sort(edges.begin(),edges.end());
+	return edges;
+}
+
+int main() {
+	for(unsigned seed=1; seed<=8; seed++) {
+		CSRGraph graph;
+		randomGraph(700,2+seed%3,20+seed*10,seed,graph);
+		long long unsigned n = graph.nodes;
+
+		//everything reachable from each node, filled in reverse id order
+		vector<vector<bool> > reach(n,vector<bool>(n,false));
+		for(long long unsigned u=n; u-- > 0; ) {
+			for(long long unsigned e=graph.succOffset[u]; e<graph.succOffset[u+1]; e++) {
+				long long unsigned w = graph.succ[e];
+				reach[u][w] = true;
+				for(long long unsigned x=w+1; x<n; x++)
+					if(reach[w][x])
+						reach[u][x] = true;
+			}
+		}
+
+		vector<Edge> expected;
+		for(long long unsigned u=0; u<n; u++) {
+			for(long long unsigned e=graph.succOffset[u]; e<graph.succOffset[u+1]; e++) {
+				long long unsigned v = graph.succ[e];
+				bool implied = false;
+				for(long long unsigned f=graph.succOffset[u]; f<graph.succOffset[u+1]; f++) {
+					long long unsigned w = graph.succ[f];
+					if(w != v && reach[w][v])
+						implied = true;
+				}
+				if(!implied)
+					expected.push_back(Edge(u,v));
+			}
+		}
+		sort(expected.begin(),expected.end());
+
+		unsigned long long blockSizes[] = {64,128,0};
+		unsigned threadCounts[] = {1,3};
+		for(unsigned b=0; b<3; b++) {
+			for(unsigned t=0; t<2; t++) {
+				TransitiveReduction reduction(threadCounts[t]);
+				reduction.blockSize = blockSizes[b];
+				CSRGraph reduced;
+				long long unsigned removed = reduction.reduce(graph,reduced);
+				string name = "seed " + to_string(seed) + " block " + to_string(blockSizes[b]) + " threads " + to_string(threadCounts[t]);
+
+				check(edgesOf(reduced) == expected,"edges " + name);
+				check(removed == graph.edges - expected.size() && reduction.removed == removed,"removed " + name);
+
+				bool types = reduced.nodes == n;
+				for(long long unsigned i=0; types && i<n; i++)
+					types = reduced.opType(i) == graph.opType(i) && reduced.memType(i) == graph.memType(i);
+				check(types,"node types " + name);
+			}
+		}
+	}
+
+	return checked("transitiveReduction");
+}
@@ -281,8 +281,14 @@ public:
 		 */
 		unsigned index = ceil(log(a1size)/log(2))-2;
 
-		unsigned blockSize = blockSizes[index];
+		return dotProductBlockedRead(a1size,a2size,blockSizes[index]);
+	}
 
+	/*
+	 * Blocked dot product reading each block in as needed, with the given
+	 * block size (see BlockTuner for picking one)
+	 */
+	static T dotProductBlockedRead(int a1size, int a2size, unsigned blockSize) {
 		//stores final result
 		T result;
 		//stores intermediate blocked results for final summation later
@@ -757,10 +763,42 @@ public:
 	 */
 	static void matrixMatrixBlockMultiply(unsigned long m1size, unsigned long m2size, unsigned long blockSize) {
 
-
+		//m1 is m1size x m2size and m2 is m2size x m1size, so the result is m1size x m1size
 		//loop through all row blocks of m1 & col blocks of m2
 		for(unsigned i=0; i<m1size/blockSize; i++) {
-			//perform individual matrix multiplications on
+			for(unsigned j=0; j<m1size/blockSize; j++) {
+				//result block, accumulated over all k (stores are not traced so it is not written back)
+				matrix c;
+				for(unsigned r=0; r<blockSize; r++) {
+					array tmp(blockSize);
+					c.push_back(tmp);
+				}
+
+				//perform individual matrix multiplications on each pair of blocks
+				for(unsigned k=0; k<m2size/blockSize; k++) {
+					//read in block (i,k) of m1 and block (k,j) of m2 (transposed)
+					matrix a;
+					matrix b;
+					for(unsigned r=0; r<blockSize; r++) {
+						array tmpA(blockSize);
+						array tmpB(blockSize);
+						a.push_back(tmpA);
+						b.push_back(tmpB);
+					}
+
+					for(unsigned r=0; r<blockSize; r++) {
+						for(unsigned col=0; col<blockSize; col++) {
+							T partial = dotProduct(&(a[r]),&(b[col]));
+
+							//accumulate the partial products of each pair of blocks
+							if(k == 0)
+								c[r][col] = partial;
+							else
+								c[r][col] = c[r][col] + partial;
+						}
+					}
+				}
+			}
 		}
 	}
 
@@ -0,0 +1,290 @@
+/*
+ * This file is part of the GraphCodeLibrary.
+ * 
+ * GraphCodeLibrary is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * GraphCodeLibrary is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with GraphCodeLibrary.  If not, see <http://www.gnu.org/licenses/>.
+ * 
+ * sweep.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+#include <string>
+#include <thread>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "Data.h"
+#include "CSRGraph.h"
+#include "linearAlgebra.h"
+
+/*
+ * Runs the LinearAlgebra kernels over ranges of sizes (and block sizes for
+ * the blocked read dot product and the block based matrix multiply) and
+ * collects the graph statistics of
+ * every configuration into one table. The tracing state is global to the
+ * process, so each configuration is traced in its own forked process and
+ * up to jobs of them run at once.
+ *
+ * usage: sweep [maxVectorSize] [maxMatrixSize] [jobs] [output]
+ */
+
+typedef LinearAlgebra<Data<int> > LA;
+typedef long long unsigned ull;
+
+struct Config {
+	string kernel;
+	unsigned size;
+	unsigned block;
+};
+
+static LA::array vec(unsigned size) {
+	return LA::array(size);
+}
+
+static LA::matrix mat(unsigned size) {
+	LA::matrix m;
+	for(unsigned i=0; i<size; i++)
+		m.push_back(LA::array(size));
+	return m;
+}
+
+/*
+ * Traces one configuration
+ */
+static void runKernel(Config &c) {
+	unsigned n = c.size;
+	string k = c.kernel;
+
+	if(k == "dotProduct") {
+		LA::array a = vec(n), b = vec(n);
+		LA::dotProduct(&a,&b);
+	}
+	else if(k == "dotProductRead")
+		LA::dotProductRead(n,n);
+	else if(k == "dotProductBlocked") {
+		LA::array a = vec(n), b = vec(n);
+		LA::dotProductBlocked(&a,&b);
+	}
+	else if(k == "dotProductBlockedRead")
+		LA::dotProductBlockedRead(n,n,c.block);
+	else if(k == "dotProductMinimal") {
+		LA::array a = vec(n), b = vec(n);
+		LA::dotProductMinimal(&a,&b);
+	}
+	else if(k == "matrixVectorMultiply") {
+		LA::matrix m = mat(n);
+		LA::array a = vec(n);
+		LA::matrixVectorMultiply(&m,&a);
+	}
+	else if(k == "matrixVectorMultiplyBlocked") {
+		LA::matrix m = mat(n);
+		LA::array a = vec(n);
+		LA::matrixVectorMultiplyBlocked(&m,&a);
+	}
+	else if(k == "matrixVectorMultiplyBlockedRead")
+		LA::matrixVectorMultiplyBlockedRead(n,n);
+	else if(k == "matrixMatrixMultiply") {
+		LA::matrix a = mat(n), b = mat(n);
+		LA::matrixMatrixMultiply(&a,&b);
+	}
+	else if(k == "matrixMatrixBlockMultiply")
+		LA::matrixMatrixBlockMultiply(n,n,c.block);
+	else if(k == "choleskyDecomposition") {
+		LA::matrix m = mat(n);
+		LA::choleskyDecomposition(&m);
+	}
+	else if(k == "choleskyDecompositionDiv") {
+		LA::matrix m = mat(n);
+		LA::choleskyDecompositionDiv(&m);
+	}
+	else if(k == "choleskyDecompositionDivAdd") {
+		LA::matrix m = mat(n);
+		LA::choleskyDecompositionDivAdd(&m);
+	}
+	else if(k == "choleskyDecompositionBlockedRead")
+		LA::choleskyDecompositionBlockedRead(n);
+	else if(k == "matrixInverse") {
+		LA::matrix m = mat(n);
+		LA::matrixInverse(&m);
+	}
+	else if(k == "matrixInverseDiv") {
+		LA::matrix m = mat(n);
+		LA::matrixInverseDiv(&m);
+	}
+	else if(k == "matrixInverseDivNeg") {
+		LA::matrix m = mat(n);
+		LA::matrixInverseDivNeg(&m);
+	}
+	else if(k == "matrixInverseBlockedRead")
+		LA::matrixInverseBlockedRead(n);
+}
+
+/*
+ * Traces the configuration and writes its statistics as one line:
+ * nodes edges depth width maxLive memAccesses (see CSRGraph::maxLive)
+ */
+static void measure(Config &c, FILE *out) {
+	Data<int>::debug = false;
+	runKernel(c);
+
+	CSRGraph graph(*Data<int>::getMatrix(),opCount);
+	vector<ull> levels = graph.levels();
+	vector<ull> histogram = CSRGraph::stageHistogram(levels);
+
+	ull width = 0;
+	for(ull s=0; s<histogram.size(); s++)
+		if(histogram[s] > width)
+			width = histogram[s];
+
+	ull mem = 0;
+	for(ull i=0; i<graph.nodes; i++)
+		mem += graph.memType(i);
+
+	fprintf(out,"%llu %llu %llu %llu %llu %llu\n",graph.nodes,graph.edges,(ull)histogram.size(),width,graph.maxLive(),mem);
+}
+
+static vector<Config> configs(unsigned maxVector, unsigned maxMatrix) {
+	const char *vectorKernels[] = {"dotProduct","dotProductRead","dotProductBlocked","dotProductMinimal"};
+	const char *matrixKernels[] = {"matrixVectorMultiply","matrixVectorMultiplyBlocked","matrixVectorMultiplyBlockedRead",
+			"matrixMatrixMultiply","choleskyDecomposition","choleskyDecompositionDiv","choleskyDecompositionDivAdd",
+			"choleskyDecompositionBlockedRead","matrixInverse","matrixInverseDiv","matrixInverseDivNeg","matrixInverseBlockedRead"};
+
+	vector<Config> list;
+	//the blocked dot products only support powers of 2 from 4
+	for(unsigned k=0; k<sizeof(vectorKernels)/sizeof(char*); k++)
+		for(unsigned n=4; n<=maxVector; n*=2) {
+			Config c = {vectorKernels[k],n,0};
+			list.push_back(c);
+		}
+	for(unsigned k=0; k<sizeof(matrixKernels)/sizeof(char*); k++)
+		for(unsigned n=4; n<=maxMatrix; n*=2) {
+			Config c = {matrixKernels[k],n,0};
+			list.push_back(c);
+		}
+	for(unsigned n=4; n<=maxVector; n*=2)
+		for(unsigned b=1; b<=n; b*=2) {
+			Config c = {"dotProductBlockedRead",n,b};
+			list.push_back(c);
+		}
+	for(unsigned n=4; n<=maxMatrix; n*=2)
+		for(unsigned b=1; b<=n; b*=2) {
+			Config c = {"matrixMatrixBlockMultiply",n,b};
+			list.push_back(c);
+		}
+
+	return list;
+}
+
+int main(int argc, char **argv) {
+	unsigned maxVector = (argc > 1) ? atoi(argv[1]) : 1024;
+	unsigned maxMatrix = (argc > 2) ? atoi(argv[2]) : 16;
+	unsigned jobs = (argc > 3) ? atoi(argv[3]) : thread::hardware_concurrency();
+	string output = (argc > 4) ? argv[4] : "sweep.csv";
+	if(jobs == 0)
+		jobs = 1;
+
+	vector<Config> list = configs(maxVector,maxMatrix);
+	vector<string> results(list.size());
+	vector<pid_t> pids(list.size(),0);
+	vector<FILE*> pipes(list.size(),(FILE*)NULL);
+
+	//fork up to jobs children at a time, each writes its line to a pipe
+	unsigned running = 0;
+	for(unsigned next=0, done=0; done<list.size(); ) {
+		if(next < list.size() && running < jobs) {
+			int fd[2];
+			if(pipe(fd) != 0) {
+				printf("Unable to create pipe\n");
+				return 1;
+			}
+			fflush(stdout);
+			pid_t pid = fork();
+			if(pid == 0) {
+				close(fd[0]);
+				//the kernels print progress, keep it out of the table
+				if(freopen("/dev/null","w",stdout) == NULL)
+					_exit(1);
+				FILE *out = fdopen(fd[1],"w");
+				measure(list[next],out);
+				fclose(out);
+				_exit(0);
+			}
+			close(fd[1]);
+			pids[next] = pid;
+			pipes[next] = fdopen(fd[0],"r");
+			next++;
+			running++;
+			continue;
+		}
+
+		//collect the next child to finish
+		int status;
+		pid_t pid = wait(&status);
+		if(pid == -1) {
+			if(errno == EINTR)
+				continue;
+
+			//no children left to wait for, so the running jobs are lost
+			printf("Unable to wait for the running jobs\n");
+			for(unsigned i=0; i<list.size(); i++) {
+				if(pipes[i] == NULL)
+					continue;
+				results[i] = "failed\n";
+				fclose(pipes[i]);
+				pipes[i] = NULL;
+				running--;
+				done++;
+			}
+			continue;
+		}
+
+		for(unsigned i=0; i<list.size(); i++) {
+			if(pids[i] != pid || pipes[i] == NULL)
+				continue;
+			char line[256];
+			if(WIFEXITED(status) && WEXITSTATUS(status) == 0 && fgets(line,sizeof(line),pipes[i]) != NULL)
+				results[i] = line;
+			else
+				results[i] = "failed\n";
+			fclose(pipes[i]);
+			pipes[i] = NULL;
+			printf("%s %u %u: %s",list[i].kernel.c_str(),list[i].size,list[i].block,results[i].c_str());
+			running--;
+			done++;
+		}
+	}
+
+	FILE *fp = fopen(output.c_str(),"w");
+	if(fp == NULL) {
+		printf("Unable to open %s for writing\n",output.c_str());
+		return 1;
+	}
+	fprintf(fp,"kernel,size,block,nodes,edges,depth,width,maxLive,memAccesses\n");
+	for(unsigned i=0; i<list.size(); i++) {
+		ull v[6];
+		if(sscanf(results[i].c_str(),"%llu %llu %llu %llu %llu %llu",&v[0],&v[1],&v[2],&v[3],&v[4],&v[5]) == 6)
+			fprintf(fp,"%s,%u,%u,%llu,%llu,%llu,%llu,%llu,%llu\n",list[i].kernel.c_str(),list[i].size,list[i].block,v[0],v[1],v[2],v[3],v[4],v[5]);
+		else
+			fprintf(fp,"%s,%u,%u,failed,,,,,\n",list[i].kernel.c_str(),list[i].size,list[i].block);
+	}
+	fclose(fp);
+
+	return 0;
+}